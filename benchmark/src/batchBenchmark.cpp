@@ -0,0 +1,44 @@
+#include "benchmark.h"
+#include "batch.h"
+#include "engine.h"
+#include <algorithm>
+#include <thread>
+
+
+void batchBenchmark()
+{
+	const unsigned cores = std::max(std::thread::hardware_concurrency(), 1u);
+	for (size_t count : { 16, 256, 4096 }) {
+		const size_t jobCount = std::max<size_t>(1000000 / count, 1);
+		const std::string size = ", diagrams " + std::to_string(jobCount) + ", sites " + std::to_string(count);
+		std::vector<std::vector<Voronoi::Point>> sites;
+		std::vector<Voronoi::BatchJob> jobs;
+		for (size_t i = 0; i < jobCount; ++i) {
+			sites.push_back(uniformSites(count, static_cast<unsigned>(i)));
+		}
+		for (const auto & jobSites : sites) {
+			jobs.emplace_back(jobSites.data(), jobSites.size());
+		}
+
+		std::vector<Voronoi::Edge> edges;
+		double seconds = measure([&]() {
+			for (const auto & jobSites : sites) {
+				Voronoi::generateEdges(jobSites, edges, Voronoi::BoundingBox(), Voronoi::Engine::Fortune);
+				benchmarkSink = static_cast<double>(edges.size());
+			}
+		});
+		report("One by one" + size, jobCount, seconds);
+
+		for (unsigned threads = 1; threads <= cores; threads *= 2) {
+			Voronoi::ThreadPool pool(threads);
+			Voronoi::BatchGenerator batch(pool);
+			std::vector<std::vector<Voronoi::Edge>> results(jobCount);
+			batch.generate(jobs.data(), jobs.size(), results.data());  // warm up the buffers
+			seconds = measure([&]() {
+				batch.generate(jobs.data(), jobs.size(), results.data());
+				benchmarkSink = static_cast<double>(results.back().size());
+			});
+			report("Batch, threads " + std::to_string(threads) + size, jobCount, seconds);
+		}
+	}
+}
@@ -0,0 +1,73 @@
+#include "benchmark.h"
+#include <random>
+#include <iostream>
+#include <iomanip>
+
+
+volatile double benchmarkSink = 0;
+
+
+std::vector<Voronoi::Point> uniformSites(size_t count, unsigned seed)
+{
+	std::mt19937 generator(seed);
+	std::uniform_real_distribution<double> distribution(0.0, 1.0);
+	std::vector<Voronoi::Point> sites;
+	sites.reserve(count);
+	for (size_t i = 0; i < count; ++i) {
+		const double x = distribution(generator);
+		sites.emplace_back(x, distribution(generator));
+	}
+	return sites;
+}
+
+
+
+std::vector<Voronoi::Point> clusteredSites(size_t count, unsigned seed)
+{
+	std::mt19937 generator(seed);
+	std::uniform_real_distribution<double> uniform(0.2, 0.8);
+	std::normal_distribution<double> normal(0.0, 0.02);
+	std::vector<Voronoi::Point> centers;
+	for (int i = 0; i < 5; ++i) {
+		const double x = uniform(generator);
+		centers.emplace_back(x, uniform(generator));
+	}
+
+	std::vector<Voronoi::Point> sites;
+	sites.reserve(count);
+	while (sites.size() < count) {
+		const Voronoi::Point & center = centers[sites.size() % centers.size()];
+		const double x = center.x() + normal(generator);
+		const Voronoi::Point site(x, center.y() + normal(generator));
+		if (site.x() > 0.0 && site.x() < 1.0 && site.y() > 0.0 && site.y() < 1.0) {
+			sites.push_back(site);
+		}
+	}
+	return sites;
+}
+
+void report(const std::string & name, size_t calls, double seconds)
+{
+	// Pick readable units
+	double perCall = seconds / calls;
+	const char * unit = "s";
+	for (const char * smaller : { "ms", "us", "ns" }) {
+		if (perCall >= 1.0) {
+			break;
+		}
+		perCall *= 1000.0;
+		unit = smaller;
+	}
+	std::cout << std::left << std::setw(48) << name << std::right
+		<< std::setw(12) << std::fixed << std::setprecision(2) << perCall << " " << unit << "/call"
+		<< std::setw(16) << std::setprecision(0) << calls / seconds << " calls/s" << std::endl;
+}
+
+
+void reportShare(const std::string & name, size_t count, size_t total)
+{
+	const double percent = total > 0 ? 100.0 * count / total : 0.0;
+	std::cout << std::left << std::setw(48) << name << std::right
+		<< std::setw(12) << count << " of " << total
+		<< std::setw(10) << std::fixed << std::setprecision(1) << percent << " %" << std::endl;
+}
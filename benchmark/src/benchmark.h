@@ -0,0 +1,45 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include "point.h"
+#include <vector>
+#include <string>
+#include <chrono>
+
+
+/// Results are written here, so that the compiler can't optimize the measured code away
+extern volatile double benchmarkSink;
+
+/// Uniformly distributed random sites in the unit square
+std::vector<Voronoi::Point> uniformSites(size_t count, unsigned seed);
+
+/// Sites in a few Gaussian clusters, clipped to the unit square
+std::vector<Voronoi::Point> clusteredSites(size_t count, unsigned seed);
+
+/// Print throughput of `calls` calls which took `seconds`
+void report(const std::string & name, size_t calls, double seconds);
+
+/// Print a count and its share of the total
+void reportShare(const std::string & name, size_t count, size_t total);
+
+/// Return duration of `function()` in seconds
+template <typename Function>
+double measure(Function function)
+{
+	const auto start = std::chrono::steady_clock::now();
+	function();
+	const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	return elapsed.count();
+}
+
+
+// Benchmark suites
+void geometryBenchmark();
+void voronoiBenchmark();
+void engineBenchmark();
+void batchBenchmark();
+void eventQueueBenchmark();
+void kineticBenchmark();
+
+
+#endif  // BENCHMARK_H
@@ -0,0 +1,36 @@
+#include "benchmark.h"
+#include "engine.h"
+#include <algorithm>
+#include <thread>
+
+
+void engineBenchmark()
+{
+	const unsigned cores = std::max(std::thread::hardware_concurrency(), 1u);
+	for (size_t count : { 1000, 10000, 100000, 1000000 }) {
+		const auto sites = uniformSites(count, 1);
+		const size_t repetitions = std::max<size_t>(1000000 / count, 1);
+		const std::string size = ", sites " + std::to_string(count);
+
+		std::vector<Voronoi::Edge> edges;
+		double seconds = measure([&]() {
+			for (size_t r = 0; r < repetitions; ++r) {
+				Voronoi::generateEdges(sites, edges, Voronoi::BoundingBox(), Voronoi::Engine::Fortune);
+				benchmarkSink = static_cast<double>(edges.size());
+			}
+		});
+		report("Fortune" + size, repetitions, seconds);
+
+		// The insertion is sequential, the threads run only the ordering before it and the dual after it
+		for (unsigned threads = 1; threads <= cores; threads *= 2) {
+			Voronoi::ThreadPool pool(threads);
+			seconds = measure([&]() {
+				for (size_t r = 0; r < repetitions; ++r) {
+					Voronoi::generateEdges(sites, edges, Voronoi::BoundingBox(), Voronoi::Engine::Delaunay, &pool);
+					benchmarkSink = static_cast<double>(edges.size());
+				}
+			});
+			report("Delaunay, pre/post on " + std::to_string(threads) + " threads" + size, repetitions, seconds);
+		}
+	}
+}
@@ -0,0 +1,66 @@
+#include "benchmark.h"
+#include "eventqueue.h"
+#include "voronoi.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+
+namespace
+{
+	/// Sweep over the sites like the generator does: pop the events above each site
+	/// and push two events at about a circle radius below it
+	void sweep(Voronoi::VertexEventQueue & queue, const std::vector<double> & sweeplines)
+	{
+		std::mt19937 generator(1);
+		std::exponential_distribution<double> distribution(std::sqrt(static_cast<double>(sweeplines.size())));
+		for (double sweepline : sweeplines) {
+			while (!queue.empty() && queue.top()->site().y() >= sweepline) {
+				queue.pop();
+			}
+			for (int i = 0; i < 2; ++i) {
+				queue.push(queue.create(Voronoi::Point(0.5, sweepline - distribution(generator))));
+			}
+		}
+		while (!queue.empty()) {
+			queue.pop();
+		}
+	}
+}  // end of anonymous namespace
+
+
+void eventQueueBenchmark()
+{
+	const size_t count = 100000;
+	for (bool isClustered : { false, true }) {
+		const auto sites = isClustered ? clusteredSites(count, 1) : uniformSites(count, 1);
+		const std::string input = isClustered ? ", clustered" : ", uniform";
+		std::vector<double> sweeplines;
+		for (const auto & site : sites) {
+			sweeplines.push_back(site.y());
+		}
+		std::sort(sweeplines.rbegin(), sweeplines.rend());
+
+		Voronoi::VertexEventQueue queue;
+		for (size_t buckets : { size_t(0), count }) {
+			const size_t repetitions = 10;
+			const double seconds = measure([&]() {
+				for (size_t r = 0; r < repetitions; ++r) {
+					queue.reset(1.0, 0.0, buckets);
+					sweep(queue, sweeplines);
+				}
+			});
+			const std::string name = buckets == 0 ? "Heap" : (queue.isCalendar() ? "Calendar" : "Calendar (fell back to heap)");
+			report(name + input + ", events " + std::to_string(2 * count), repetitions, seconds);
+		}
+
+		const size_t repetitions = 5;
+		const double seconds = measure([&]() {
+			for (size_t r = 0; r < repetitions; ++r) {
+				Voronoi::Generator generator(sites);
+				benchmarkSink = static_cast<double>(generator.getEdges().size());
+			}
+		});
+		report("Generator" + input + ", sites " + std::to_string(count), repetitions, seconds);
+	}
+}
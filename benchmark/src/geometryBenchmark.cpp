@@ -0,0 +1,63 @@
+#include "benchmark.h"
+#include "geometry.h"
+
+
+void geometryBenchmark()
+{
+	using Voronoi::Point;
+	const size_t count = 1 << 16;
+	const size_t repetitions = 64;
+	const auto a = uniformSites(count, 1);
+	const auto b = uniformSites(count, 2);
+	const auto c = uniformSites(count, 3);
+	std::vector<Point> centers(count);
+	std::vector<double> x(count);
+
+	double seconds = measure([&]() {
+		for (size_t r = 0; r < repetitions; ++r) {
+			for (size_t i = 0; i < count; ++i) {
+				centers[i] = Voronoi::circumcenter(a[i], b[i], c[i]);
+			}
+			benchmarkSink = centers[r].x();
+		}
+	});
+	report("circumcenter", count * repetitions, seconds);
+
+	seconds = measure([&]() {
+		for (size_t r = 0; r < repetitions; ++r) {
+			Voronoi::circumcenters(a.data(), b.data(), c.data(), centers.data(), count);
+			benchmarkSink = centers[r].x();
+		}
+	});
+	report("circumcenters (batch)", count * repetitions, seconds);
+
+	seconds = measure([&]() {
+		for (size_t r = 0; r < repetitions; ++r) {
+			for (size_t i = 0; i < count; i += 2) {
+				Voronoi::circumcenters(&a[i], &b[i], &c[i], &centers[i], 2);
+			}
+			benchmarkSink = centers[r].x();
+		}
+	});
+	report("circumcenters (pairs, as in the sweep)", count * repetitions, seconds);
+
+	// Directrix under all foci
+	const double directrix = -1.0;
+	seconds = measure([&]() {
+		for (size_t r = 0; r < repetitions; ++r) {
+			for (size_t i = 0; i < count; ++i) {
+				x[i] = Voronoi::parabolaIntersectionX(a[i], b[i], directrix);
+			}
+			benchmarkSink = x[r];
+		}
+	});
+	report("parabolaIntersectionX", count * repetitions, seconds);
+
+	seconds = measure([&]() {
+		for (size_t r = 0; r < repetitions; ++r) {
+			Voronoi::parabolaIntersectionsX(a.data(), b.data(), directrix, x.data(), count);
+			benchmarkSink = x[r];
+		}
+	});
+	report("parabolaIntersectionsX (batch)", count * repetitions, seconds);
+}
@@ -0,0 +1,51 @@
+#include "benchmark.h"
+#include "kinetic.h"
+#include "voronoi.h"
+#include <cmath>
+#include <random>
+
+
+void kineticBenchmark()
+{
+	const size_t count = 10000;
+	const size_t ticks = 50;
+	const double tick = 0.01;
+	const auto sites = uniformSites(count, 1);
+
+	// Speeds as the fraction of the average site distance per tick
+	for (double speed : { 0.01, 0.1 }) {
+		std::mt19937 generator(2);
+		std::uniform_real_distribution<double> distribution(-1.0, 1.0);
+		const double scale = speed / std::sqrt(static_cast<double>(count)) / tick;
+		std::vector<Voronoi::Point> velocities;
+		for (size_t i = 0; i < count; ++i) {
+			const double x = distribution(generator);
+			velocities.emplace_back(scale * x, scale * distribution(generator));
+		}
+		const std::string name = ", step " + std::to_string(static_cast<int>(100 * speed)) + "%, sites " + std::to_string(count);
+
+		// Rebuild every tick, the sites which leave the box are dropped
+		Voronoi::Generator rebuilt;
+		std::vector<Voronoi::Point> moved = sites;
+		double seconds = measure([&]() {
+			for (size_t t = 0; t < ticks; ++t) {
+				for (size_t i = 0; i < count; ++i) {
+					moved[i] = moved[i] + velocities[i] * tick;
+				}
+				rebuilt.update(moved);
+				benchmarkSink = static_cast<double>(rebuilt.getEdges().size());
+			}
+		});
+		report("Generator update per tick" + name, ticks, seconds);
+
+		// Each tick ends with the edges like the rebuild does
+		Voronoi::KineticDiagram kinetic(sites, velocities);
+		seconds = measure([&]() {
+			for (size_t t = 0; t < ticks; ++t) {
+				kinetic.advance(tick);
+				benchmarkSink = static_cast<double>(kinetic.getEdges().size());
+			}
+		});
+		report("KineticDiagram per tick" + name, ticks, seconds);
+	}
+}
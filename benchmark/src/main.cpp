@@ -0,0 +1,41 @@
+#include "benchmark.h"
+#include <string>
+#include <iostream>
+
+
+/// @mainpage
+///
+/// Run all benchmarks: "VoronoiBenchmark".
+/// Run selected suites: "VoronoiBenchmark geometry".
+///
+/// Build in Release mode, the numbers are meaningless otherwise.
+
+
+int main(int argc, char * argv[])
+{
+	struct Suite
+	{
+		const char * name;
+		void (*run)();
+	};
+	const Suite suites[] = {
+		{ "geometry", &geometryBenchmark },
+		{ "voronoi", &voronoiBenchmark },
+		{ "engine", &engineBenchmark },
+		{ "batch", &batchBenchmark },
+		{ "queue", &eventQueueBenchmark },
+		{ "kinetic", &kineticBenchmark },
+	};
+
+	for (const auto & suite : suites) {
+		bool isSelected = (argc == 1);
+		for (int i = 1; i < argc; ++i) {
+			isSelected = isSelected || (suite.name == std::string(argv[i]));
+		}
+		if (isSelected) {
+			std::cout << "\n --Benchmark " << suite.name << "--" << std::endl;
+			suite.run();
+		}
+	}
+	return 0;
+}
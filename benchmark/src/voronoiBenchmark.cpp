@@ -0,0 +1,233 @@
+#include "benchmark.h"
+#include "voronoi.h"
+#include "smallgenerator.h"
+#include "diagramdiff.h"
+#include "adjacency.h"
+#include "interpolation.h"
+#include <chrono>
+#include <cmath>
+#include <thread>
+#include <algorithm>
+
+
+void voronoiBenchmark()
+{
+	for (size_t count : { 1000, 10000, 100000 }) {
+		const auto sites = uniformSites(count, 1);
+		const size_t repetitions = 1000000 / count;
+		double seconds = measure([&]() {
+			for (size_t r = 0; r < repetitions; ++r) {
+				Voronoi::Generator generator(sites);
+				benchmarkSink = static_cast<double>(generator.getEdges().size());
+			}
+		});
+		report("Generator, sites " + std::to_string(count), repetitions, seconds);
+
+		// Disabled events are skipped, the released events are recycled by the later ones
+		const Voronoi::Generator fresh(sites);
+		const Voronoi::EventStatistics & events = fresh.getEventStatistics();
+		reportShare("Vertex events disabled, sites " + std::to_string(count), events.Disabled, events.Created);
+		reportShare("Vertex events recycled, sites " + std::to_string(count), events.Recycled, events.Created);
+
+		// The buffers and the vertex events of the previous diagram are reused
+		Voronoi::Generator generator;
+		seconds = measure([&]() {
+			for (size_t r = 0; r < repetitions; ++r) {
+				generator.generate(sites);
+				benchmarkSink = static_cast<double>(generator.getEdges().size());
+			}
+		});
+		report("Generator reused, sites " + std::to_string(count), repetitions, seconds);
+		reportShare("Vertex events recycled when reused, sites " + std::to_string(count), generator.getEventStatistics().Recycled,
+			generator.getEventStatistics().Created);
+
+		// The cost of checking the token and the deadline
+		const Voronoi::CancellationToken token;
+		const auto deadline = std::chrono::steady_clock::now() + std::chrono::hours(1);
+		seconds = measure([&]() {
+			for (size_t r = 0; r < repetitions; ++r) {
+				generator.generate(sites.data(), sites.size(), Voronoi::BoundingBox(), token, deadline);
+				benchmarkSink = static_cast<double>(generator.getEdges().size());
+			}
+		});
+		report("Generator cancellable, sites " + std::to_string(count), repetitions, seconds);
+
+		// Animation, the sites move by a fraction of their distance between the frames
+		std::vector<Voronoi::Point> frames[2] = { sites, sites };
+		const double shift = 0.1 / std::sqrt(static_cast<double>(count));
+		for (size_t i = 0; i < count; ++i) {
+			frames[1][i] = sites[i] + Voronoi::Point(0.0, (i % 2 == 0) ? shift : -shift);
+		}
+		seconds = measure([&]() {
+			for (size_t r = 0; r < repetitions; ++r) {
+				generator.generate(frames[r % 2]);
+				benchmarkSink = static_cast<double>(generator.getEdges().size());
+			}
+		});
+		report("Generator frames, sites " + std::to_string(count), repetitions, seconds);
+
+		seconds = measure([&]() {
+			for (size_t r = 0; r < repetitions; ++r) {
+				generator.update(frames[r % 2]);
+				benchmarkSink = static_cast<double>(generator.getEdges().size());
+			}
+		});
+		report("Generator update frames, sites " + std::to_string(count), repetitions, seconds);
+
+		// The delta to a diagram with every hundredth site moved instead of the whole diagram
+		auto fewMoved = sites;
+		for (size_t i = 0; i < count; i += 100) {
+			fewMoved[i] = frames[1][i];
+		}
+		const Voronoi::Generator before(sites);
+		const Voronoi::Generator after(fewMoved);
+		seconds = measure([&]() {
+			for (size_t r = 0; r < repetitions; ++r) {
+				const Voronoi::DiagramDiff diff(before.getEdges(), after.getEdges());
+				benchmarkSink = static_cast<double>(diff.changedEdges().size());
+			}
+		});
+		report("DiagramDiff 1% moved, sites " + std::to_string(count), repetitions, seconds);
+
+		// The site graph and the neighbourhoods of three hops of all the sites
+		seconds = measure([&]() {
+			for (size_t r = 0; r < repetitions; ++r) {
+				const Voronoi::AdjacencyGraph graph(before.getEdges(), count);
+				benchmarkSink = static_cast<double>(graph.neighbours().size());
+			}
+		});
+		report("AdjacencyGraph, sites " + std::to_string(count), repetitions, seconds);
+
+		const Voronoi::AdjacencyGraph graph(before.getEdges(), count);
+		std::vector<uint32_t> allSites(count);
+		for (uint32_t i = 0; i < count; ++i) {
+			allSites[i] = i;
+		}
+		Voronoi::ThreadPool ringPool(std::max(std::thread::hardware_concurrency(), 1u));
+		seconds = measure([&]() {
+			benchmarkSink = static_cast<double>(graph.kRings(allSites, 3, &ringPool).size());
+		});
+		report("AdjacencyGraph 3-rings, threads " + std::to_string(ringPool.size()) + ", sites " + std::to_string(count), 1, seconds);
+
+		seconds = measure([&]() {
+			for (size_t r = 0; r < repetitions; ++r) {
+				benchmarkSink = static_cast<double>(graph.minimumSpanningTree(sites.data(), &ringPool).size());
+			}
+		});
+		report("AdjacencyGraph spanning tree, sites " + std::to_string(count), repetitions, seconds);
+
+		seconds = measure([&]() {
+			for (size_t r = 0; r < repetitions; ++r) {
+				benchmarkSink = static_cast<double>(graph.nearestNeighbours(sites.data(), &ringPool).size());
+			}
+		});
+		report("AdjacencyGraph nearest neighbours, sites " + std::to_string(count), repetitions, seconds);
+
+		// A grid of 256 x 256 values from one triangulation
+		const Voronoi::Triangulation triangulation(sites);
+		std::vector<double> values(count);
+		for (size_t i = 0; i < count; ++i) {
+			values[i] = sites[i].x() * sites[i].y();
+		}
+		const Voronoi::NaturalNeighbourInterpolator interpolator(triangulation, values);
+		std::vector<Voronoi::Point> grid;
+		for (int y = 0; y < 256; ++y) {
+			for (int x = 0; x < 256; ++x) {
+				grid.emplace_back((x + 0.5) / 256.0, (y + 0.5) / 256.0);
+			}
+		}
+		std::vector<double> results(grid.size());
+		for (Voronoi::ThreadPool * gridPool : { static_cast<Voronoi::ThreadPool *>(nullptr), &ringPool }) {
+			seconds = measure([&]() {
+				interpolator.interpolate(grid.data(), grid.size(), results.data(), gridPool);
+				benchmarkSink = results[grid.size() / 2];
+			});
+			report("Sibson grid 256x256, threads " + std::to_string(gridPool ? gridPool->size() : 1) +
+				", sites " + std::to_string(count), 1, seconds);
+		}
+
+		// Panning a viewport of a quarter of the area, the sweep against clipping the kept diagram
+		auto viewport = [](size_t r) {
+			const double offset = 0.5 * static_cast<double>(r % 16) / 16.0;
+			return Voronoi::BoundingBox(offset, offset + 0.5, 0.25, 0.75);
+		};
+		seconds = measure([&]() {
+			for (size_t r = 0; r < repetitions; ++r) {
+				generator.generate(sites, viewport(r));
+				benchmarkSink = static_cast<double>(generator.getEdges().size());
+			}
+		});
+		report("Generator viewport, sites " + std::to_string(count), repetitions, seconds);
+
+		generator.generateUnclipped(sites);
+		seconds = measure([&]() {
+			for (size_t r = 0; r < repetitions; ++r) {
+				generator.clip(viewport(r));
+				benchmarkSink = static_cast<double>(generator.getEdges().size());
+			}
+		});
+		report("Generator clip viewport, sites " + std::to_string(count), repetitions, seconds);
+
+		// A grid of 16 x 16 tiles, a sweep per tile against one diagram clipped to all tiles
+		const uint32_t tileCount = 16;
+		seconds = measure([&]() {
+			for (size_t r = 0; r < repetitions; ++r) {
+				for (uint32_t row = 0; row < tileCount; ++row) {
+					for (uint32_t column = 0; column < tileCount; ++column) {
+						generator.generate(sites, Voronoi::BoundingBox(static_cast<double>(column) / tileCount,
+							static_cast<double>(column + 1) / tileCount, static_cast<double>(row) / tileCount,
+							static_cast<double>(row + 1) / tileCount));
+						benchmarkSink = static_cast<double>(generator.getEdges().size());
+					}
+				}
+			}
+		});
+		report("Generator per tile, sites " + std::to_string(count), repetitions, seconds);
+
+		Voronoi::ThreadPool pool(std::max(std::thread::hardware_concurrency(), 1u));
+		generator.generateUnclipped(sites);
+		for (Voronoi::ThreadPool * tilePool : { static_cast<Voronoi::ThreadPool *>(nullptr), &pool }) {
+			seconds = measure([&]() {
+				for (size_t r = 0; r < repetitions; ++r) {
+					benchmarkSink = static_cast<double>(generator.clipTiles(Voronoi::BoundingBox(), tileCount, tileCount, tilePool).size());
+				}
+			});
+			report("Generator clip tiles, threads " + std::to_string(tilePool ? tilePool->size() : 1) + ", sites " +
+				std::to_string(count), repetitions, seconds);
+		}
+
+		// All memory of a diagram from one buffer, freed at once
+		Voronoi::MonotonicBuffer buffer;
+		seconds = measure([&]() {
+			for (size_t r = 0; r < repetitions; ++r) {
+				{
+					Voronoi::Generator generator(sites, Voronoi::BoundingBox(), &buffer);
+					benchmarkSink = static_cast<double>(generator.getEdges().size());
+				}
+				buffer.release();
+			}
+		});
+		report("Generator monotonic buffer, sites " + std::to_string(count), repetitions, seconds);
+	}
+
+	// Tiny diagrams, the sweep against the fixed-capacity path
+	for (size_t count : { 8, 32, 64 }) {
+		const auto sites = uniformSites(count, 1);
+		const size_t repetitions = 2000000 / count;
+		double seconds = measure([&]() {
+			for (size_t r = 0; r < repetitions; ++r) {
+				Voronoi::Generator generator(sites);
+				benchmarkSink = static_cast<double>(generator.getEdges().size());
+			}
+		});
+		report("Generator, sites " + std::to_string(count), repetitions, seconds);
+
+		seconds = measure([&]() {
+			for (size_t r = 0; r < repetitions; ++r) {
+				Voronoi::SmallGenerator<64> generator(sites);
+				benchmarkSink = static_cast<double>(generator.getEdges().size());
+			}
+		});
+		report("SmallGenerator, sites " + std::to_string(count), repetitions, seconds);
+	}
+}
@@ -7,17 +7,48 @@ TEMPLATE = lib
 TARGET = voronoi
 
 SOURCES += \
+    adjacency.cpp \
+    async.cpp \
+    batch.cpp \
     beachline.cpp \
+    delaunay.cpp \
+    diagramdiff.cpp \
+    edgegrid.cpp \
+    engine.cpp \
+    eventqueue.cpp \
     geometry.cpp \
+    interpolation.cpp \
+    kinetic.cpp \
+    memoryresource.cpp \
+    threadpool.cpp \
+    tiling.cpp \
     voronoi.cpp
 
 HEADERS += \
+    adjacency.h \
+    async.h \
+    batch.h \
     beachline.h \
+    boundingbox.h \
+    cancellation.h \
+    delaunay.h \
+    diagramdiff.h \
     edge.h \
+    edgegrid.h \
+    engine.h \
     event.h \
+    eventqueue.h \
+    fixedvector.h \
     geometry.h \
+    interpolation.h \
+    kinetic.h \
     make_unique.h \
+    memoryresource.h \
+    mesh.h \
     point.h \
+    smallgenerator.h \
+    threadpool.h \
+    tiling.h \
     voronoi.h
 
 
@@ -0,0 +1,219 @@
+#include "adjacency.h"
+#include <algorithm>
+
+
+namespace
+{
+	/// Call `function(begin, end)` for the range [0, count) in the pool or in this thread
+	template <typename Function>
+	void forRange(Voronoi::ThreadPool * pool, size_t count, Function function)
+	{
+		if (pool) {
+			pool->parallelFor(count, function);
+		}
+		else {
+			function(0, count);
+		}
+	}
+
+
+	double squaredDistance(const Voronoi::Point & a, const Voronoi::Point & b)
+	{
+		const double dx = a.x() - b.x();
+		const double dy = a.y() - b.y();
+		return dx * dx + dy * dy;
+	}
+
+
+	/// Pair of neighbouring sites with the square of their distance
+	struct Candidate
+	{
+		double Length;
+		uint32_t First;
+		uint32_t Second;
+	};
+
+
+	/// Disjoint sets of the sites, the trees are kept flat by path halving and union by size
+	class UnionFind
+	{
+	public:
+		explicit UnionFind(size_t count) :
+			_parents(count),
+			_sizes(count, 1)
+		{
+			for (size_t i = 0; i < count; ++i) {
+				_parents[i] = static_cast<uint32_t>(i);
+			}
+		}
+
+		uint32_t find(uint32_t item)
+		{
+			while (_parents[item] != item) {
+				_parents[item] = _parents[_parents[item]];
+				item = _parents[item];
+			}
+			return item;
+		}
+
+		/// Join the sets of the items, false if they were joined already
+		bool join(uint32_t first, uint32_t second)
+		{
+			first = find(first);
+			second = find(second);
+			if (first == second) {
+				return false;
+			}
+			if (_sizes[first] < _sizes[second]) {
+				std::swap(first, second);
+			}
+			_parents[second] = first;
+			_sizes[first] += _sizes[second];
+			return true;
+		}
+
+	private:
+		std::vector<uint32_t> _parents;
+		std::vector<uint32_t> _sizes;
+	};
+}  // end of anonymous namespace
+
+
+std::vector<uint32_t> Voronoi::AdjacencyGraph::kRing(uint32_t site, unsigned k) const
+{
+	if (site >= siteCount()) {
+		throw std::out_of_range("kRing: Site out of range!");
+	}
+
+	// Each hop is sorted, so a candidate is looked up by binary search. A neighbour of a site
+	// lies one hop closer, in the same hop or one hop further, so only two hops are searched.
+	std::vector<uint32_t> ring(1, site);
+	std::vector<uint32_t> candidates;
+	size_t previousBegin = 0;
+	size_t hopBegin = 0;
+	size_t hopEnd = 1;
+	for (unsigned hop = 0; hop < k && hopBegin < hopEnd; ++hop) {
+		candidates.clear();
+		for (size_t i = hopBegin; i < hopEnd; ++i) {
+			candidates.insert(candidates.end(), neighboursBegin(ring[i]), neighboursEnd(ring[i]));
+		}
+		std::sort(candidates.begin(), candidates.end());
+		candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+		for (uint32_t candidate : candidates) {
+			if (!std::binary_search(ring.begin() + previousBegin, ring.begin() + hopBegin, candidate) &&
+				!std::binary_search(ring.begin() + hopBegin, ring.begin() + hopEnd, candidate)) {
+				ring.push_back(candidate);
+			}
+		}
+		previousBegin = hopBegin;
+		hopBegin = hopEnd;
+		hopEnd = ring.size();
+	}
+	return ring;
+}
+
+
+std::vector<std::vector<uint32_t>> Voronoi::AdjacencyGraph::kRings(const std::vector<uint32_t> & sites, unsigned k,
+	ThreadPool * pool) const
+{
+	std::vector<std::vector<uint32_t>> rings(sites.size());
+	forRange(pool, sites.size(), [&](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i) {
+			rings[i] = kRing(sites[i], k);
+		}
+	});
+	return rings;
+}
+
+
+std::vector<std::pair<uint32_t, uint32_t>> Voronoi::AdjacencyGraph::minimumSpanningTree(const Point * sites,
+	ThreadPool * pool) const
+{
+	// Each pair once, the rows are sorted so the greater neighbours are at the end of the row
+	const size_t count = siteCount();
+	std::vector<uint64_t> starts(count + 1, 0);
+	for (size_t site = 0; site < count; ++site) {
+		const uint32_t * greater = std::upper_bound(neighboursBegin(static_cast<uint32_t>(site)),
+			neighboursEnd(static_cast<uint32_t>(site)), static_cast<uint32_t>(site));
+		starts[site + 1] = starts[site] + static_cast<uint64_t>(neighboursEnd(static_cast<uint32_t>(site)) - greater);
+	}
+	std::vector<Candidate> candidates(static_cast<size_t>(starts.back()));
+	forRange(pool, count, [&](size_t begin, size_t end) {
+		for (size_t site = begin; site < end; ++site) {
+			const uint32_t * last = neighboursEnd(static_cast<uint32_t>(site));
+			Candidate * candidate = candidates.data() + starts[site];
+			for (const uint32_t * neighbour = last - (starts[site + 1] - starts[site]); neighbour != last; ++neighbour) {
+				*candidate++ = Candidate{ squaredDistance(sites[site], sites[*neighbour]), static_cast<uint32_t>(site), *neighbour };
+			}
+		}
+	});
+
+	// Equal lengths are ordered by the sites, so the tree doesn't depend on the pool
+	parallelSort(pool, candidates.begin(), candidates.end(), [](const Candidate & left, const Candidate & right) {
+		if (left.Length != right.Length) {
+			return left.Length < right.Length;
+		}
+		return left.First != right.First ? left.First < right.First : left.Second < right.Second;
+	});
+
+	std::vector<std::pair<uint32_t, uint32_t>> tree;
+	UnionFind components(count);
+	for (const Candidate & candidate : candidates) {
+		if (components.join(candidate.First, candidate.Second)) {
+			tree.emplace_back(candidate.First, candidate.Second);
+			if (tree.size() + 1 == count) {
+				break;
+			}
+		}
+	}
+	return tree;
+}
+
+
+std::vector<uint32_t> Voronoi::AdjacencyGraph::nearestNeighbours(const Point * sites, ThreadPool * pool) const
+{
+	std::vector<uint32_t> nearest(siteCount(), NoSite);
+	forRange(pool, siteCount(), [&](size_t begin, size_t end) {
+		for (size_t site = begin; site < end; ++site) {
+			double nearestDistance = 0.0;
+			for (const uint32_t * neighbour = neighboursBegin(static_cast<uint32_t>(site));
+				neighbour != neighboursEnd(static_cast<uint32_t>(site)); ++neighbour) {
+				const double distance = squaredDistance(sites[site], sites[*neighbour]);
+				if (nearest[site] == NoSite || distance < nearestDistance) {
+					nearest[site] = *neighbour;
+					nearestDistance = distance;
+				}
+			}
+		}
+	});
+	return nearest;
+}
+
+
+void Voronoi::AdjacencyGraph::_sortRows(ThreadPool * pool)
+{
+	// A periodic diagram may have several edges of the same sites, their duplicates are dropped
+	const size_t count = siteCount();
+	std::vector<uint64_t> lengths(count);
+	forRange(pool, count, [this, &lengths](size_t begin, size_t end) {
+		for (size_t site = begin; site < end; ++site) {
+			uint32_t * first = _neighbours.data() + _offsets[site];
+			uint32_t * last = _neighbours.data() + _offsets[site + 1];
+			std::sort(first, last);
+			lengths[site] = static_cast<uint64_t>(std::unique(first, last) - first);
+		}
+	});
+
+	// Close the gaps of the duplicates, the rows only move towards the front
+	uint64_t size = 0;
+	for (size_t site = 0; site < count; ++site) {
+		const uint64_t begin = _offsets[site];
+		_offsets[site] = size;
+		if (begin != size) {
+			std::copy(_neighbours.begin() + begin, _neighbours.begin() + begin + lengths[site], _neighbours.begin() + size);
+		}
+		size += lengths[site];
+	}
+	_offsets[count] = size;
+	_neighbours.resize(static_cast<size_t>(size));
+}
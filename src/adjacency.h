@@ -0,0 +1,157 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2015 Lukáš Bednařík l.bednarik@gmail.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+#ifndef ADJACENCY_H
+#define ADJACENCY_H
+
+#include "point.h"
+#include "edge.h"
+#include "threadpool.h"
+#include <vector>
+#include <utility>
+#include <stdexcept>
+#include <cstdint>
+#include <cstddef>
+
+
+namespace Voronoi
+{
+	/// Nearest neighbour of a site with no neighbours
+	const uint32_t NoSite = 0xffffffff;
+
+
+	/// Graph of the sites in compressed sparse row form, two sites are neighbours if they share an edge
+	///
+	/// The neighbours of site `i` are `neighbours()[offsets()[i]]` up to `offsets()[i + 1]`, sorted
+	/// by index and without duplicates. Both arrays are contiguous, so breadth-first searches and
+	/// label propagation run over them without chasing pointers.
+	class AdjacencyGraph
+	{
+	public:
+		/// Build the graph from the edges of a diagram of `siteCount` sites
+		///
+		/// The edges are binned by their site indices in two linear passes and the rows are
+		/// sorted in the pool.
+		template <typename Edges>
+		AdjacencyGraph(const Edges & edges, size_t siteCount, ThreadPool * pool = nullptr);
+
+		size_t siteCount() const;
+		const std::vector<uint64_t> & offsets() const;
+		const std::vector<uint32_t> & neighbours() const;
+
+		/// Neighbours of the site as a range of pointers
+		const uint32_t * neighboursBegin(uint32_t site) const;
+		const uint32_t * neighboursEnd(uint32_t site) const;
+
+		/// Sites at most `k` hops from the site, the site first, then by the hop count and index
+		std::vector<uint32_t> kRing(uint32_t site, unsigned k) const;
+
+		/// k-rings of the sites, the queries run in the pool
+		std::vector<std::vector<uint32_t>> kRings(const std::vector<uint32_t> & sites, unsigned k,
+			ThreadPool * pool = nullptr) const;
+
+		/// Edges of the Euclidean minimum spanning tree of the sites, `siteCount()` points
+		///
+		/// The tree is a subgraph of the Delaunay triangulation, so the neighbours are the only
+		/// candidates. Kruskal's algorithm sorts them by length in the pool and joins the sites
+		/// with a union-find. The smaller site of a pair is first; separate parts of the graph
+		/// give a forest.
+		std::vector<std::pair<uint32_t, uint32_t>> minimumSpanningTree(const Point * sites, ThreadPool * pool = nullptr) const;
+
+		/// Nearest other site of every site, `NoSite` for a site with no neighbours
+		///
+		/// The nearest site is a neighbour in the diagram, so only the neighbours are measured.
+		std::vector<uint32_t> nearestNeighbours(const Point * sites, ThreadPool * pool = nullptr) const;
+
+	private:
+		std::vector<uint64_t> _offsets;
+		std::vector<uint32_t> _neighbours;
+
+		void _sortRows(ThreadPool * pool);
+	};
+}
+
+
+// Implementation
+
+template <typename Edges>
+Voronoi::AdjacencyGraph::AdjacencyGraph(const Edges & edges, size_t siteCount, ThreadPool * pool) :
+	_offsets(siteCount + 1, 0)
+{
+	// Count the neighbours of the sites, then place them
+	for (const Edge & edge : edges) {
+		if (edge.leftSite() >= siteCount || edge.rightSite() >= siteCount) {
+			throw std::out_of_range("AdjacencyGraph: Edge refers to a site out of range!");
+		}
+		if (edge.leftSite() != edge.rightSite()) {
+			++_offsets[edge.leftSite() + 1];
+			++_offsets[edge.rightSite() + 1];
+		}
+	}
+	for (size_t site = 0; site < siteCount; ++site) {
+		_offsets[site + 1] += _offsets[site];
+	}
+	_neighbours.resize(static_cast<size_t>(_offsets.back()));
+	std::vector<uint64_t> cursors(_offsets.begin(), _offsets.end() - 1);
+	for (const Edge & edge : edges) {
+		if (edge.leftSite() != edge.rightSite()) {
+			_neighbours[static_cast<size_t>(cursors[edge.leftSite()]++)] = edge.rightSite();
+			_neighbours[static_cast<size_t>(cursors[edge.rightSite()]++)] = edge.leftSite();
+		}
+	}
+	_sortRows(pool);
+}
+
+
+inline size_t Voronoi::AdjacencyGraph::siteCount() const
+{
+	return _offsets.size() - 1;
+}
+
+
+inline const std::vector<uint64_t> & Voronoi::AdjacencyGraph::offsets() const
+{
+	return _offsets;
+}
+
+
+inline const std::vector<uint32_t> & Voronoi::AdjacencyGraph::neighbours() const
+{
+	return _neighbours;
+}
+
+
+inline const uint32_t * Voronoi::AdjacencyGraph::neighboursBegin(uint32_t site) const
+{
+	return _neighbours.data() + _offsets[site];
+}
+
+
+inline const uint32_t * Voronoi::AdjacencyGraph::neighboursEnd(uint32_t site) const
+{
+	return _neighbours.data() + _offsets[site + 1];
+}
+
+
+#endif  // ADJACENCY_H
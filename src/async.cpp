@@ -0,0 +1,59 @@
+#include "async.h"
+#include <chrono>
+#include <exception>
+
+
+namespace
+{
+	/// State of one asynchronous generation, shared because `std::function` must be copyable
+	struct AsyncTask
+	{
+		std::vector<Voronoi::Point> sites;
+		Voronoi::BoundingBox boundingBox;
+		Voronoi::CancellationToken token;
+		Voronoi::Deadline deadline;
+		Voronoi::MemoryResource * resource;
+		std::promise<std::unique_ptr<Voronoi::Generator>> promise;
+	};
+}  // end of anonymous namespace
+
+
+Voronoi::Executor Voronoi::poolExecutor(ThreadPool & pool)
+{
+	ThreadPool * poolPointer = &pool;
+	return [poolPointer](std::function<void()> task) {
+		poolPointer->post(std::move(task));
+	};
+}
+
+
+std::future<std::unique_ptr<Voronoi::Generator>> Voronoi::generateAsync(const Executor & executor, std::vector<Point> sites,
+	const BoundingBox & boundingBox, const CancellationToken & token, Deadline deadline, MemoryResource * resource)
+{
+	auto task = std::make_shared<AsyncTask>();
+	task->sites.swap(sites);
+	task->boundingBox = boundingBox;
+	task->token = token;
+	task->deadline = deadline;
+	task->resource = resource;
+	auto future = task->promise.get_future();
+
+	executor([task]() {
+		try {
+			// Don't start the work which is not wanted anymore
+			if (task->token.isCancelled()) {
+				throw Cancelled("Generation of the Voronoi diagram was cancelled!");
+			}
+			if (task->deadline != noDeadline() && std::chrono::steady_clock::now() >= task->deadline) {
+				throw DeadlineExceeded("Generation of the Voronoi diagram ran past its deadline!");
+			}
+			std::unique_ptr<Generator> generator(new Generator(task->resource));
+			generator->generate(task->sites.data(), task->sites.size(), task->boundingBox, task->token, task->deadline);
+			task->promise.set_value(std::move(generator));
+		}
+		catch (...) {
+			task->promise.set_exception(std::current_exception());
+		}
+	});
+	return future;
+}
@@ -0,0 +1,57 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2015 Lukáš Bednařík l.bednarik@gmail.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+#ifndef ASYNC_H
+#define ASYNC_H
+
+#include "voronoi.h"
+#include "threadpool.h"
+#include <functional>
+#include <future>
+#include <memory>
+#include <vector>
+
+
+namespace Voronoi
+{
+	/// Runs a task somewhere else, e.g. posts it to a thread pool or to an event loop
+	typedef std::function<void(std::function<void()>)> Executor;
+
+	/// Executor posting the tasks to the pool, the pool must outlive the tasks
+	Executor poolExecutor(ThreadPool & pool);
+
+
+	/// Calculate Voronoi diagram on the executor
+	///
+	/// The sites are copied, so the caller doesn't have to keep them. The future holds the
+	/// finished generator or the exception of the generation, i.e. `Cancelled` when the token
+	/// is cancelled and `DeadlineExceeded` when the deadline passes. The deadline counts the
+	/// time in the executor's queue as well, a task started too late gives up at once.
+	std::future<std::unique_ptr<Generator>> generateAsync(const Executor & executor, std::vector<Point> sites,
+		const BoundingBox & boundingBox = BoundingBox(), const CancellationToken & token = CancellationToken(),
+		Deadline deadline = noDeadline(), MemoryResource * resource = newDeleteResource());
+}
+
+
+#endif  // ASYNC_H
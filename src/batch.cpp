@@ -0,0 +1,121 @@
+#include "batch.h"
+#include "voronoi.h"
+#include "smallgenerator.h"
+#include "geometry.h"
+#include <functional>
+#include <mutex>
+
+
+namespace
+{
+	/// Jobs [begin, end) of one thread. The owner takes jobs from the front, thieves from the back.
+	struct JobRange
+	{
+		std::mutex mutex;
+		size_t begin;
+		size_t end;
+		char padding[64];  ///< Keep the ranges of the threads in separate cache lines
+
+		bool pop(size_t & job)
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			if (begin == end) {
+				return false;
+			}
+			job = begin++;
+			return true;
+		}
+
+		/// Move the back half of the jobs to the empty range `thief`
+		bool steal(JobRange & thief)
+		{
+			// One lock at a time, two thieves robbing each other mustn't deadlock
+			size_t stolenBegin, stolenEnd;
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				if (begin == end) {
+					return false;
+				}
+				stolenBegin = end - (end - begin + 1) / 2;
+				stolenEnd = end;
+				end = stolenBegin;
+			}
+			std::lock_guard<std::mutex> lock(thief.mutex);
+			thief.begin = stolenBegin;
+			thief.end = stolenEnd;
+			return true;
+		}
+	};
+
+
+	void computeJob(const Voronoi::BatchJob & job, Voronoi::MonotonicBuffer & buffer, std::vector<Voronoi::Edge> & result)
+	{
+		result.clear();
+		if (job.SiteCount <= Voronoi::SmallSiteCount && !job.Box.Periodic) {
+			const Voronoi::SmallGenerator<Voronoi::SmallSiteCount> small(job.Sites, job.SiteCount, job.Box);
+			result.assign(small.getEdges().begin(), small.getEdges().end());
+		}
+		else {
+			// Clipped like the edges of `SmallGenerator` and `generateEdges`
+			{
+				Voronoi::Generator generator(&buffer);
+				generator.generate(job.Sites, job.SiteCount, job.Box);
+				for (Voronoi::Edge edge : generator.getEdges()) {
+					if (Voronoi::clipEdge(edge, job.Box) && edge.begin() != edge.end()) {
+						result.push_back(edge);
+					}
+				}
+			}
+			buffer.release();
+		}
+	}
+}  // end of anonymous namespace
+
+
+Voronoi::BatchGenerator::BatchGenerator(ThreadPool & pool) :
+	_pool(pool)
+{
+	for (unsigned i = 0; i < pool.size(); ++i) {
+		_buffers.emplace_back(new MonotonicBuffer());
+	}
+}
+
+
+Voronoi::BatchGenerator::~BatchGenerator()
+{
+}
+
+
+void Voronoi::BatchGenerator::generate(const BatchJob * jobs, size_t count, std::vector<Edge> * results)
+{
+	const size_t threadCount = _buffers.size();
+	std::vector<JobRange> ranges(threadCount);
+	for (size_t i = 0; i < threadCount; ++i) {
+		ranges[i].begin = count * i / threadCount;
+		ranges[i].end = count * (i + 1) / threadCount;
+	}
+
+	std::vector<std::function<void()>> tasks;
+	for (size_t thread = 0; thread < threadCount; ++thread) {
+		tasks.emplace_back([&, thread]() {
+			MonotonicBuffer & buffer = *_buffers[thread];
+			JobRange & own = ranges[thread];
+			while (true) {
+				size_t job;
+				while (own.pop(job)) {
+					computeJob(jobs[job], buffer, results[job]);
+				}
+
+				// Steal from the other threads, give up when all of them are empty
+				bool isStolen = false;
+				for (size_t i = 1; i < threadCount && !isStolen; ++i) {
+					isStolen = ranges[(thread + i) % threadCount].steal(own);
+				}
+				if (!isStolen) {
+					return;
+				}
+			}
+		});
+	}
+	_pool.run(tasks);
+}
@@ -0,0 +1,79 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2015 Lukáš Bednařík l.bednarik@gmail.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef BATCH_H
+#define BATCH_H
+
+#include "point.h"
+#include "edge.h"
+#include "boundingbox.h"
+#include "threadpool.h"
+#include "memoryresource.h"
+#include <vector>
+#include <memory>
+#include <cstddef>
+
+
+namespace Voronoi
+{
+	/// One diagram of a batch, the sites are not copied
+	struct BatchJob
+	{
+		BatchJob() : Sites(nullptr), SiteCount(0) {}
+		BatchJob(const Point * sites, size_t siteCount, const BoundingBox & boundingBox = BoundingBox()) :
+			Sites(sites), SiteCount(siteCount), Box(boundingBox) {}
+
+		const Point * Sites;
+		size_t SiteCount;
+		BoundingBox Box;
+	};
+
+
+	/// Computes many independent diagrams on a thread pool
+	///
+	/// Each thread of the pool keeps its own `MonotonicBuffer`. The generator of a job takes all
+	/// its memory, including every edge of its list, from the buffer of its thread and the buffer
+	/// is released after the job, so its block is reused from job to job and from batch to batch.
+	/// The jobs are split between the threads evenly and a thread which runs out of jobs steals
+	/// half of the remaining jobs of another one.
+	class BatchGenerator
+	{
+	public:
+		explicit BatchGenerator(ThreadPool & pool);
+		~BatchGenerator();
+
+		/// Compute the edges of `jobs[i]` into `results[i]`
+		///
+		/// The results are overwritten, so vectors kept from the previous batch don't allocate.
+		/// Jobs with up to `SmallSiteCount` sites use `SmallGenerator`. The edges are clipped to
+		/// the box of the job like by `generateEdges`.
+		void generate(const BatchJob * jobs, size_t count, std::vector<Edge> * results);
+
+	private:
+		ThreadPool & _pool;
+		std::vector<std::unique_ptr<MonotonicBuffer>> _buffers;
+	};
+}
+
+
+#endif  // BATCH_H
@@ -1,219 +1,226 @@
 #include "beachline.h"
 #include "geometry.h"
-#include "make_unique.h"
 #include <string>
+#include <stdexcept>
+#include <utility>
 
 
-namespace
+Voronoi::Beachline::Beachline(const PointVector & sites, MemoryResource * resource) :
+	_sites(&sites),
+	_nodes(resource),
+	_freeNodes(resource),
+	_root(NullIndex)
 {
-	/// Disable all event's containing parabola's site
-	void disableEvents(Voronoi::ParabolaNode * parabola)
-	{
-		if (parabola->leftSibling()) {
-			parabola->leftSibling()->setEvent(nullptr);
-		}
-		if (parabola->rightSibling()) {
-			parabola->rightSibling()->setEvent(nullptr);
-		}
-		parabola->setEvent(nullptr);
-	}
 }
 
 
-Voronoi::ParabolaNode::ParabolaNode() :
-	_parent(nullptr),
-	_leftSibling(nullptr),
-	_rightSibling(nullptr)
+Voronoi::Beachline::Beachline(Beachline && other, const PointVector & sites) :
+	_sites(&sites),
+	_nodes(std::move(other._nodes)),
+	_freeNodes(std::move(other._freeNodes)),
+	_root(other._root)
 {
+	other._root = NullIndex;
 }
 
 
-Voronoi::ParabolaNode::ParabolaNode(const Point & site) :
-	Parabola(site),
-	_parent(nullptr),
-	_leftSibling(nullptr),
-	_rightSibling(nullptr)
+void Voronoi::Beachline::clear()
 {
+	_nodes.clear();
+	_freeNodes.clear();
+	_root = NullIndex;
 }
 
 
-void Voronoi::ParabolaNode::_createChildren(const Point & leftSite, const Point & rightSite)
+Voronoi::Beachline::Index Voronoi::Beachline::_createNode(Index site)
 {
-	_leftChild = make_unique<ParabolaNode>(leftSite);
-	_leftChild->_parent = this;
-	_rightChild = make_unique<ParabolaNode>(rightSite);
-	_rightChild->_parent = this;
-	_cross(_leftSibling, leftChild());
-	_cross(leftChild(), rightChild());
-	_cross(rightChild(), _rightSibling);
+	Node node;
+	node.parent = NullIndex;
+	node.leftChild = NullIndex;
+	node.rightChild = NullIndex;
+	node.leftSibling = NullIndex;
+	node.rightSibling = NullIndex;
+	node.site = site;
+	node.edge = nullptr;
+	node.event = nullptr;
+	if (!_freeNodes.empty()) {
+		const Index index = _freeNodes.back();
+		_freeNodes.pop_back();
+		_nodes[index] = node;
+		return index;
+	}
+	_nodes.push_back(node);
+	return static_cast<Index>(_nodes.size() - 1);
 }
 
 
-void Voronoi::ParabolaNode::_cross(ParabolaNode * left, ParabolaNode * right)
+void Voronoi::Beachline::_createChildren(Index node, Index leftSite, Index rightSite)
 {
-	if (left) {
-		left->_rightSibling = right;
-	}
-	if (right) {
-		right->_leftSibling = left;
-	}
+	// Create both children first, `_nodes` may reallocate
+	const Index left = _createNode(leftSite);
+	const Index right = _createNode(rightSite);
+	_nodes[left].parent = node;
+	_nodes[right].parent = node;
+	_nodes[node].leftChild = left;
+	_nodes[node].rightChild = right;
+	_nodes[node].site = NullIndex;
+	_cross(_nodes[node].leftSibling, left);
+	_cross(left, right);
+	_cross(right, _nodes[node].rightSibling);
 }
 
 
-std::unique_ptr<Voronoi::ParabolaNode> Voronoi::ParabolaNode::_releaseTwin(Voronoi::ParabolaNode * parabola)
+void Voronoi::Beachline::_cross(Index left, Index right)
 {
-	Voronoi::ParabolaNode * parent = parabola->parent();
-	std::unique_ptr<Voronoi::ParabolaNode> otherBranch;
-	if (parent->leftChild() == parabola) {
-		otherBranch = std::move(parent->_rightChild);
-		parent->_rightChild.reset();
-	}
-	else if (parent->rightChild() == parabola) {
-		otherBranch = std::move(parent->_leftChild);
-		parent->_leftChild.reset();
+	if (left != NullIndex) {
+		_nodes[left].rightSibling = right;
 	}
-	else {
-		throw std::logic_error("_releaseTwin: Invalid parent!");
+	if (right != NullIndex) {
+		_nodes[right].leftSibling = left;
 	}
-	otherBranch->_parent = nullptr;
-	return otherBranch;
 }
 
 
-void Voronoi::ParabolaNode::_move(std::unique_ptr<ParabolaNode> parabola)
+Voronoi::Beachline::Index Voronoi::Beachline::emplaceParabola(Index site)
 {
-	_leftSibling = parabola->_leftSibling;
-	_rightSibling = parabola->_rightSibling;
-	_leftChild = std::move(parabola->_leftChild);
-	_rightChild = std::move(parabola->_rightChild);
-	setSite(parabola->site());
-	setEdge(parabola->edge());
-	setEvent(parabola->event());
-}
-
-
-void Voronoi::ParabolaNode::_setParentsTwin(ParabolaNode * parent, std::unique_ptr<ParabolaNode> parabola)
-{
-	auto grandparent = parent->parent();
-	parabola->_parent = grandparent;
-	if (grandparent->leftChild() == parent) {
-		grandparent->_leftChild = std::move(parabola);
-	}
-	else if (grandparent->rightChild() == parent) {
-		grandparent->_rightChild = std::move(parabola);
-	}
-	else {
-		throw std::logic_error("_setParentsTwin: Invalid parent!");
+	if (isEmpty()) {
+		_root = _createNode(site);
+		return _root;
 	}
+	return emplaceParabola(site, findParabola((*_sites)[site]));
 }
 
 
-Voronoi::ParabolaNode * Voronoi::ParabolaNode::emplaceParabola(const Point & site)
+Voronoi::Beachline::Index Voronoi::Beachline::emplaceParabola(Index site, Index parabola)
 {
-	if (!isValid()) {
-		setSite(site);
-		return this;
-	}
-
-	ParabolaNode * parabola = findParabola(site);
-	assert(parabola->site().y() >= site.y());
+	const Point & point = (*_sites)[site];
+	assert(focus(parabola).y() >= point.y());
 
 	// disable event including parabola->sites in the middle of a triple.
-	parabola->setEvent(nullptr);
-
-	// Handle special case when: one_parabola_in_root && parabolaSite.y() == site.y()
-	const Point parabolaSite = parabola->site();
-	if (isLeaf(this) && parabolaSite.y() == site.y()) {
-		if (site.x() < parabolaSite.x()) {
-			parabola->_createChildren(site, parabolaSite);
-			return parabola->leftChild();
+	setEvent(parabola, nullptr);
+
+	// Both foci lie on the sweepline, the parabolas are vertical rays side by side.
+	// The breakpoint with the right sibling moves to the right child.
+	const Index parabolaSite = _nodes[parabola].site;
+	const Point & parabolaFocus = focus(parabola);
+	if (parabolaFocus.y() == point.y()) {
+		const bool isLeft = point.x() < parabolaFocus.x();
+		if (isLeft) {
+			_createChildren(parabola, site, parabolaSite);
 		}
 		else {
-			parabola->_createChildren(parabolaSite, site);
-			return parabola->rightChild();
+			_createChildren(parabola, parabolaSite, site);
 		}
+		setEdge(_nodes[parabola].rightChild, edge(parabola));
+		setEdge(parabola, nullptr);
+		return isLeft ? _nodes[parabola].leftChild : _nodes[parabola].rightChild;
 	}
-	else if (site.x() < parabolaSite.x()) {
+	else if (point.x() < parabolaFocus.x()) {
 		// Create new parabola branch
-		parabola->_createChildren(Point(), parabolaSite);
-		parabola->leftChild()->_createChildren(parabolaSite, site);
+		_createChildren(parabola, NullIndex, parabolaSite);
+		const Index branch = _nodes[parabola].leftChild;
+		_createChildren(branch, parabolaSite, site);
 
 		// Set edge to right sibling from the original parabola
-		parabola->_rightChild->setEdge(parabola->edge());  // the rightmost parabola
-		parabola->setEdge(nullptr);
+		setEdge(_nodes[parabola].rightChild, edge(parabola));  // the rightmost parabola
+		setEdge(parabola, nullptr);
 
-		return parabola->leftChild()->rightChild();
+		return _nodes[branch].rightChild;
 	}
 	else {
 		// Create new parabola branch
-		parabola->_createChildren(parabolaSite, Point());
-		parabola->rightChild()->_createChildren(site, parabolaSite);
+		_createChildren(parabola, parabolaSite, NullIndex);
+		const Index branch = _nodes[parabola].rightChild;
+		_createChildren(branch, site, parabolaSite);
 
 		// Set edge to right sibling from the original parabola
-		parabola->rightChild()->_rightChild->setEdge(parabola->edge());  // the rightmost parabola
-		parabola->setEdge(nullptr);
+		setEdge(_nodes[branch].rightChild, edge(parabola));  // the rightmost parabola
+		setEdge(parabola, nullptr);
 
-		return parabola->rightChild()->leftChild();
+		return _nodes[branch].leftChild;
 	}
 }
 
 
-void Voronoi::ParabolaNode::removeParabola(ParabolaNode * parabola)
+void Voronoi::Beachline::removeParabola(Index parabola)
 {
 	assert(isLeaf(parabola));
 
-	// Check if parabola is root
-	if (parabola == this) {
-		setInvalid();
+	// Any event involving parabola's site should be deleted.
+	const Index left = _nodes[parabola].leftSibling;
+	const Index right = _nodes[parabola].rightSibling;
+	if (left != NullIndex) {
+		setEvent(left, nullptr);
 	}
+	if (right != NullIndex) {
+		setEvent(right, nullptr);
+	}
+	setEvent(parabola, nullptr);
 
-	// Any event involving parabolaNode->site() should be deleted.
-	disableEvents(parabola);
+	// Check if parabola is root
+	if (parabola == _root) {
+		clear();
+		return;
+	}
 
 	// Set siblings
-	ParabolaNode::_cross(parabola->_leftSibling, parabola->_rightSibling);
+	_cross(left, right);
 
-	// Release parent's another child
-	auto otherBranch = _releaseTwin(parabola);
+	// Move parent's another child into parent's place
+	const Index parent = _nodes[parabola].parent;
+	Index otherBranch;
+	if (_nodes[parent].leftChild == parabola) {
+		otherBranch = _nodes[parent].rightChild;
+	}
+	else if (_nodes[parent].rightChild == parabola) {
+		otherBranch = _nodes[parent].leftChild;
+	}
+	else {
+		throw std::logic_error("removeParabola: Invalid parent!");
+	}
 
-	// Move parent's another child into parent's parent
-	if (parabola->parent()->parent()) {
-		_setParentsTwin(parabola->parent(), std::move(otherBranch));
+	const Index grandparent = _nodes[parent].parent;
+	_nodes[otherBranch].parent = grandparent;
+	if (grandparent == NullIndex) {
+		_root = otherBranch;
+	}
+	else if (_nodes[grandparent].leftChild == parent) {
+		_nodes[grandparent].leftChild = otherBranch;
+	}
+	else if (_nodes[grandparent].rightChild == parent) {
+		_nodes[grandparent].rightChild = otherBranch;
 	}
 	else {
-		/// Make "otherBranch" to be "this"
-		_move(std::move(otherBranch));
+		throw std::logic_error("removeParabola: Invalid grandparent!");
 	}
+
+	_freeNodes.push_back(parabola);
+	_freeNodes.push_back(parent);
 }
 
 
-Voronoi::ParabolaNode * Voronoi::ParabolaNode::findParabola(const Point & point)
+Voronoi::Beachline::Index Voronoi::Beachline::findParabola(const Point & point) const
 {
-	ParabolaNode * par = this;
+	Index node = _root;
 
 	// Binary search
-	while (!isLeaf(par)) {
-		// Find the closest leave which is on the left of current node
-		const ParabolaNode * left = par->leftChild();
+	while (!isLeaf(node)) {
+		// Find the closest leave which is on the left of current node.
+		// The closest leave on the right is its right sibling.
+		Index left = _nodes[node].leftChild;
 		while (!isLeaf(left)) {
-			left = left->rightChild();
-		}
-
-		// Find the closest leave which is on the right of current node
-		const ParabolaNode * right = par->rightChild();
-		while (!isLeaf(right)) {
-			right = right->leftChild();
+			left = _nodes[left].rightChild;
 		}
+		const Index right = _nodes[left].rightSibling;
 
 		// "x" is the intersection of two parabolas
-		const double x = parabolaIntersectionX(left->site(), right->site(), point.y());
+		const double x = parabolaIntersectionX(focus(left), focus(right), point.y());
 		if (x > point.x()) {
-			par = par->_leftChild.get();
+			node = _nodes[node].leftChild;
 		}
 		else {
-			par = par->_rightChild.get();
+			node = _nodes[node].rightChild;
 		}
 	}
-	return par;
+	return node;
 }
-
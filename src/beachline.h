@@ -27,251 +27,213 @@
 #include "point.h"
 #include "event.h"
 #include "edge.h"
-#include <memory>
+#include "memoryresource.h"
+#include <vector>
+#include <cstdint>
 #include <cassert>
 
 
 namespace Voronoi
 {
-	class Parabola
+	/// Sites of a diagram, the memory comes from the resource of the generator
+	typedef std::vector<Point, Allocator<Point>> PointVector;
+
+
+	/// Beachline is a binary tree. Leaves are parabolas, internal nodes are breakpoints.
+	///
+	/// All nodes are stored in one array and linked by 32-bit indices. Leaves refer to
+	/// the sites by index into the site array given in the constructor.
+	/// We suppose each node having both children or none!
+	class Beachline
 	{
 	public:
-		/// Constructor
-		Parabola();
+		typedef uint32_t Index;
 
-		/// Convenience constructor
-		Parabola(const Point & site);
+		/// Constructor, the nodes are allocated from the resource
+		explicit Beachline(const PointVector & sites, MemoryResource * resource = newDeleteResource());
 
-		/// Destructor
-		virtual ~Parabola() {}
+		/// Take the nodes of the other beachline, the leaves refer to the given sites from now on
+		Beachline(Beachline && other, const PointVector & sites);
 
-		/// Return true if this Parabola is invalid (no site set)
-		bool isValid() const;
+		Beachline(const Beachline &) = delete;
+		Beachline & operator=(const Beachline &) = delete;
 
-		/// Set this parabola to be empty (invalid)
-		void setInvalid();
+		/// Return true if there is no parabola in the beachline
+		bool isEmpty() const;
 
-		/// The parabola focus. Value is valid only for leafs.
-		Point site() const;
+		/// Remove all parabolas, keep the allocated memory
+		void clear();
 
-		void setSite(const Point & site);
+		/// Root of the tree
+		Index root() const;
 
-		/// Return edge
-		Edge * edge();
+		/// Construct a parabola for the site
+		///
+		/// @return New created parabola.
+		Index emplaceParabola(Index site);
 
-		/// Set edge
-		void setEdge(Edge * edge);
+		/// Construct a parabola for the site under the given parabola
+		///
+		/// The caller knows the parabola above the site, e.g. when inserting a row of sites
+		/// from left to right. @return New created parabola.
+		Index emplaceParabola(Index site, Index parabola);
 
-		/// Return event for this parabola
-		VertexEvent * event();
+		/// Remove this parabola (leaf) from the beachline
+		void removeParabola(Index parabola);
 
-		/// Set an event for this parabola
-		void setEvent(VertexEvent * event);
+		/// Return a parabola under the given point [x, sweepline_y].
+		Index findParabola(const Point & point) const;
 
-	private:
-		Point _site;
-		Edge * _edge;
-		VertexEvent * _event;
-	};
+		/// Return true if the node is a leaf (parabola)
+		bool isLeaf(Index node) const;
 
+		/// The parabola focus index. Value is valid only for leafs.
+		Index site(Index parabola) const;
 
-	/// One parabola node in a tree
-	///
-	/// We suppose ParabolaNode having both children or none!
-	class ParabolaNode : public Parabola
-	{
-	public:
-		/// Constructor
-		ParabolaNode();
+		/// The parabola focus. Value is valid only for leafs.
+		const Point & focus(Index parabola) const;
 
-		/// Convenience constructor
-		ParabolaNode(const Point & site);
+		/// Return edge
+		Edge * edge(Index node) const;
 
-		/// Destructor
-		~ParabolaNode() override {}
+		/// Set edge
+		void setEdge(Index node, Edge * edge);
 
-		/// Construct a parabola child
-		///
-		/// @return New created parabola.
-		ParabolaNode * emplaceParabola(const Point & site);
+		/// Return event for this parabola
+		VertexEvent * event(Index parabola) const;
 
-		/// Remove this parabola (child) from the beachline
-		void removeParabola(ParabolaNode * parabolaNode);
+		/// Set an event for this parabola, disable the previous one
+		void setEvent(Index parabola, VertexEvent * event);
 
-		/// Return a parabola under the given point [x, sweepline_y].
-		ParabolaNode * findParabola(const Point & point);
-		
 		/// Family functions
-		ParabolaNode * parent();
-		const ParabolaNode * parent() const;
-		ParabolaNode * leftSibling();
-		ParabolaNode * rightSibling();
-		const ParabolaNode * leftSibling() const;
-		const ParabolaNode * rightSibling() const;
-		ParabolaNode * leftChild();
-		ParabolaNode * rightChild();
-		const ParabolaNode * leftChild() const;
-		const ParabolaNode * rightChild() const;
+		Index parent(Index node) const;
+		Index leftChild(Index node) const;
+		Index rightChild(Index node) const;
+		Index leftSibling(Index parabola) const;
+		Index rightSibling(Index parabola) const;
 
 	private:
-		ParabolaNode * _parent;
-		ParabolaNode * _leftSibling;
-		ParabolaNode * _rightSibling;
-		std::unique_ptr<ParabolaNode> _leftChild;
-		std::unique_ptr<ParabolaNode> _rightChild;
+		/// 40 bytes, no virtual table
+		struct Node
+		{
+			Index parent;
+			Index leftChild;
+			Index rightChild;
+			Index leftSibling;
+			Index rightSibling;
+			Index site;
+			Edge * edge;
+			VertexEvent * event;
+		};
+
+		const PointVector * _sites;
+		std::vector<Node, Allocator<Node>> _nodes;
+		std::vector<Index, Allocator<Index>> _freeNodes;  ///< Indices of removed nodes to reuse
+		Index _root;
 
 		// Helper functions
-		void _createChildren(const Point & leftSite, const Point & rightSite);
-		void _move(std::unique_ptr<ParabolaNode> parabola);  ///< Copy everything from parabola to this
-		static std::unique_ptr<ParabolaNode> _releaseTwin(ParabolaNode * parabola);  ///< Find parent's another child and release it
-		static void _setParentsTwin(ParabolaNode * parent, std::unique_ptr<ParabolaNode> parabola);
-		static void _cross(ParabolaNode * left, ParabolaNode * right);
+		Index _createNode(Index site);
+		void _createChildren(Index node, Index leftSite, Index rightSite);
+		void _cross(Index left, Index right);
 	};
 
 
-	/// Convenience function. Return true if ParabolaNode is a leaf.
-	///
-	/// We suppose ParabolaNode having both children or none!
-	bool isLeaf(const ParabolaNode * parabolaNode);
+	/// Index of no node or no site
+	const Beachline::Index NullIndex = 0xffffffff;
 }
 
 
 
 // Implementation
 
-inline Voronoi::Parabola::Parabola() :
-	_edge(nullptr),
-	_event(nullptr)
-{
-}
-
-
-inline Voronoi::Parabola::Parabola(const Point & site) :
-	_site(site),
-	_edge(nullptr),
-	_event(nullptr)
+inline bool Voronoi::Beachline::isEmpty() const
 {
+	return _root == NullIndex;
 }
 
 
-inline void Voronoi::Parabola::setInvalid()
+inline Voronoi::Beachline::Index Voronoi::Beachline::root() const
 {
-	_site = Point();
+	return _root;
 }
 
 
-inline bool Voronoi::Parabola::isValid() const
+inline bool Voronoi::Beachline::isLeaf(Index node) const
 {
-	return !_site.isNull();
+	return _nodes[node].leftChild == NullIndex && _nodes[node].rightChild == NullIndex;
 }
 
 
-inline Voronoi::Point Voronoi::Parabola::site() const
+inline Voronoi::Beachline::Index Voronoi::Beachline::site(Index parabola) const
 {
-	return _site;
+	return _nodes[parabola].site;
 }
 
 
-inline void Voronoi::Parabola::setSite(const Point & site)
+inline const Voronoi::Point & Voronoi::Beachline::focus(Index parabola) const
 {
-	_site = site;
+	assert(_nodes[parabola].site != NullIndex);
+	return (*_sites)[_nodes[parabola].site];
 }
 
 
-inline Voronoi::Edge * Voronoi::Parabola::edge()
+inline Voronoi::Edge * Voronoi::Beachline::edge(Index node) const
 {
-	return _edge;
+	return _nodes[node].edge;
 }
 
 
-inline void Voronoi::Parabola::setEdge(Edge * edge)
+inline void Voronoi::Beachline::setEdge(Index node, Edge * edge)
 {
-	_edge = edge;
+	_nodes[node].edge = edge;
 }
 
 
-inline Voronoi::VertexEvent * Voronoi::Parabola::event()
+inline Voronoi::VertexEvent * Voronoi::Beachline::event(Index parabola) const
 {
-	return _event;
+	return _nodes[parabola].event;
 }
 
 
-inline void Voronoi::Parabola::setEvent(VertexEvent * event)
+inline void Voronoi::Beachline::setEvent(Index parabola, VertexEvent * event)
 {
-	if (_event) {
-		_event->disable();
+	Node & node = _nodes[parabola];
+	if (node.event) {
+		node.event->disable();
 	}
-	_event = event;
-}
-
-
-inline Voronoi::ParabolaNode * Voronoi::ParabolaNode::parent()
-{
-	return _parent;
-}
-
-
-inline const Voronoi::ParabolaNode * Voronoi::ParabolaNode::parent() const
-{
-	return _parent;
-}
-
-
-inline Voronoi::ParabolaNode * Voronoi::ParabolaNode::leftSibling()
-{
-	assert(isLeaf(this));
-	return _leftSibling;
-}
-
-
-inline Voronoi::ParabolaNode * Voronoi::ParabolaNode::rightSibling()
-{
-	assert(isLeaf(this));
-	return _rightSibling;
-}
-
-
-inline const Voronoi::ParabolaNode * Voronoi::ParabolaNode::leftSibling() const
-{
-	assert(isLeaf(this));
-	return _leftSibling;
-}
-
-
-inline const Voronoi::ParabolaNode * Voronoi::ParabolaNode::rightSibling() const
-{
-	assert(isLeaf(this));
-	return _rightSibling;
+	node.event = event;
 }
 
 
-inline const Voronoi::ParabolaNode * Voronoi::ParabolaNode::leftChild() const
+inline Voronoi::Beachline::Index Voronoi::Beachline::parent(Index node) const
 {
-	return _leftChild.get();
+	return _nodes[node].parent;
 }
 
 
-inline const Voronoi::ParabolaNode * Voronoi::ParabolaNode::rightChild() const
+inline Voronoi::Beachline::Index Voronoi::Beachline::leftChild(Index node) const
 {
-	return _rightChild.get();
+	return _nodes[node].leftChild;
 }
 
 
-inline Voronoi::ParabolaNode * Voronoi::ParabolaNode::leftChild()
+inline Voronoi::Beachline::Index Voronoi::Beachline::rightChild(Index node) const
 {
-	return _leftChild.get();
+	return _nodes[node].rightChild;
 }
 
 
-inline Voronoi::ParabolaNode * Voronoi::ParabolaNode::rightChild()
+inline Voronoi::Beachline::Index Voronoi::Beachline::leftSibling(Index parabola) const
 {
-	return _rightChild.get();
+	assert(isLeaf(parabola));
+	return _nodes[parabola].leftSibling;
 }
 
 
-inline bool Voronoi::isLeaf(const ParabolaNode * parabolaNode)
+inline Voronoi::Beachline::Index Voronoi::Beachline::rightSibling(Index parabola) const
 {
-	return !parabolaNode->leftChild() && !parabolaNode->rightChild();
+	assert(isLeaf(parabola));
+	return _nodes[parabola].rightSibling;
 }
 
 
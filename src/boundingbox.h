@@ -0,0 +1,103 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2015 Lukáš Bednařík l.bednarik@gmail.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef BOUNDINGBOX_H
+#define BOUNDINGBOX_H
+
+#include "point.h"
+#include <stdexcept>
+#include <cmath>
+
+
+namespace Voronoi
+{
+	/// Rectangular area of the diagram
+	///
+	/// In periodic mode the box is a torus. Sites within `Margin` of an edge of the box
+	/// get ghost copies on the opposite side, so cells wrap around the boundary.
+	struct BoundingBox
+	{
+		BoundingBox() : MinX(0), MaxX(1), MinY(0), MaxY(1), Periodic(false), Margin(0) {}
+		BoundingBox(double minX, double maxX, double minY, double maxY);
+
+		/// Return true if the point lies strictly inside the box
+		bool contains(const Point & point) const;
+
+		/// Map a point into the box by periodic translation
+		Point wrap(const Point & point) const;
+
+		double width() const;
+		double height() const;
+
+		double MinX;
+		double MaxX;
+		double MinY;
+		double MaxY;
+
+		/// Treat the box as a torus (periodic boundary conditions)
+		bool Periodic;
+
+		/// Width of the band of ghost sites in periodic mode. Zero means automatic.
+		double Margin;
+	};
+}
+
+
+// Implementation
+
+inline Voronoi::BoundingBox::BoundingBox(double minX, double maxX, double minY, double maxY) :
+	MinX(minX), MaxX(maxX), MinY(minY), MaxY(maxY), Periodic(false), Margin(0)
+{
+	if (minX >= maxX || minY >= maxY) {
+		throw std::domain_error("Mix/Max coordinates overlat!");
+	}
+}
+
+
+inline bool Voronoi::BoundingBox::contains(const Point & point) const
+{
+	return point.x() > MinX && point.x() < MaxX && point.y() > MinY && point.y() < MaxY;
+}
+
+
+inline Voronoi::Point Voronoi::BoundingBox::wrap(const Point & point) const
+{
+	const double x = point.x() - std::floor((point.x() - MinX) / width()) * width();
+	const double y = point.y() - std::floor((point.y() - MinY) / height()) * height();
+	return Point(x, y);
+}
+
+
+inline double Voronoi::BoundingBox::width() const
+{
+	return MaxX - MinX;
+}
+
+
+inline double Voronoi::BoundingBox::height() const
+{
+	return MaxY - MinY;
+}
+
+
+#endif  // BOUNDINGBOX_H
@@ -0,0 +1,103 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2015 Lukáš Bednařík l.bednarik@gmail.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+#ifndef CANCELLATION_H
+#define CANCELLATION_H
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+
+
+namespace Voronoi
+{
+	/// Point in time after which a generation gives up
+	typedef std::chrono::steady_clock::time_point Deadline;
+
+	/// No deadline
+	inline Deadline noDeadline();
+
+
+	/// Lets another thread stop a running generation
+	///
+	/// Copies share the state, so the caller keeps one copy and passes another to the work.
+	class CancellationToken
+	{
+	public:
+		CancellationToken();
+
+		/// Request the stop, the generation notices it within a few hundred events
+		void cancel();
+		bool isCancelled() const;
+
+	private:
+		std::shared_ptr<std::atomic<bool>> _isCancelled;
+	};
+
+
+	/// Thrown out of a generation stopped by its `CancellationToken`
+	class Cancelled : public std::runtime_error
+	{
+	public:
+		explicit Cancelled(const char * what) : std::runtime_error(what) {}
+	};
+
+
+	/// Thrown out of a generation which ran past its deadline
+	class DeadlineExceeded : public Cancelled
+	{
+	public:
+		explicit DeadlineExceeded(const char * what) : Cancelled(what) {}
+	};
+}
+
+
+// Implementation
+
+inline Voronoi::Deadline Voronoi::noDeadline()
+{
+	return Deadline::max();
+}
+
+
+inline Voronoi::CancellationToken::CancellationToken() :
+	_isCancelled(std::make_shared<std::atomic<bool>>(false))
+{
+}
+
+
+inline void Voronoi::CancellationToken::cancel()
+{
+	_isCancelled->store(true, std::memory_order_relaxed);
+}
+
+
+inline bool Voronoi::CancellationToken::isCancelled() const
+{
+	return _isCancelled->load(std::memory_order_relaxed);
+}
+
+
+#endif  // CANCELLATION_H
@@ -0,0 +1,336 @@
+#include "delaunay.h"
+#include "geometry.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <utility>
+
+
+namespace
+{
+	const uint32_t NoTriangle = 0xffffffff;
+
+	/// Size of the super triangle relative to the bounding box
+	const double SuperTriangleScale = 1000.0;
+
+	/// Number of cells of the Hilbert curve grid along one axis
+	const uint32_t HilbertSize = 1 << 16;
+
+	const int Next[3] = { 1, 2, 0 };
+	const int Previous[3] = { 2, 0, 1 };
+
+
+	/// Distance of the cell [x, y] along the Hilbert curve
+	uint32_t hilbertIndex(uint32_t x, uint32_t y)
+	{
+		uint32_t index = 0;
+		for (uint32_t s = HilbertSize / 2; s > 0; s /= 2) {
+			const uint32_t rx = (x & s) ? 1 : 0;
+			const uint32_t ry = (y & s) ? 1 : 0;
+			index += s * s * ((3 * rx) ^ ry);
+
+			// Rotate the quadrant
+			if (ry == 0) {
+				if (rx == 1) {
+					x = s - 1 - x;
+					y = s - 1 - y;
+				}
+				std::swap(x, y);
+			}
+		}
+		return index;
+	}
+
+
+	/// Call `function(begin, end)` for the range [0, count) in the pool or in this thread
+	template <typename Function>
+	void forRange(Voronoi::ThreadPool * pool, size_t count, Function function)
+	{
+		if (pool) {
+			pool->parallelFor(count, function);
+		}
+		else {
+			function(0, count);
+		}
+	}
+}  // end of anonymous namespace
+
+
+Voronoi::Triangulation::Triangulation(const std::vector<Point> & sites, const BoundingBox & boundingBox, ThreadPool * pool) :
+	_points(sites),
+	_sites(sites),
+	_mark(0),
+	_last(0),
+	_boundingBox(boundingBox),
+	_pool(pool)
+{
+	if (boundingBox.Periodic) {
+		throw std::domain_error("Periodic bounding box isn't supported by the triangulation!");
+	}
+
+	// The super triangle contains the whole bounding box
+	const double centerX = (boundingBox.MinX + boundingBox.MaxX) / 2.0;
+	const double centerY = (boundingBox.MinY + boundingBox.MaxY) / 2.0;
+	const double size = SuperTriangleScale * std::max(boundingBox.width(), boundingBox.height());
+	const uint32_t first = static_cast<uint32_t>(_points.size());
+	_points.emplace_back(centerX - size, centerY - size);
+	_points.emplace_back(centerX + size, centerY - size);
+	_points.emplace_back(centerX, centerY + size);
+	_triangles.push_back(Triangle{ { first, first + 1, first + 2 }, { NoTriangle, NoTriangle, NoTriangle } });
+	_marks.push_back(0);
+
+	for (uint32_t site : _insertionOrder()) {
+		_insert(site);
+	}
+}
+
+
+std::vector<uint32_t> Voronoi::Triangulation::_insertionOrder() const
+{
+	std::vector<uint32_t> order;
+	order.reserve(_sites.size());
+	for (uint32_t i = 0; i < _sites.size(); ++i) {
+		if (_boundingBox.contains(_sites[i])) {
+			order.push_back(i);
+		}
+	}
+
+	// Half of the sites goes to the last round, half of the rest to the one before and so on.
+	// The random bits are drawn in this thread, so the order doesn't depend on the pool.
+	std::mt19937 random(1);
+	std::vector<uint32_t> rounds(order.size());
+	for (auto & round : rounds) {
+		uint32_t bits = random();
+		round = 0;
+		while (bits & 1) {
+			++round;
+			bits >>= 1;
+		}
+	}
+
+	// Earlier rounds first, the Hilbert curve within a round
+	std::vector<std::pair<uint64_t, uint32_t>> keys(order.size());
+	const double scaleX = (HilbertSize - 1) / _boundingBox.width();
+	const double scaleY = (HilbertSize - 1) / _boundingBox.height();
+	forRange(_pool, order.size(), [&](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i) {
+			const Point & site = _sites[order[i]];
+			const uint32_t x = static_cast<uint32_t>((site.x() - _boundingBox.MinX) * scaleX);
+			const uint32_t y = static_cast<uint32_t>((site.y() - _boundingBox.MinY) * scaleY);
+			keys[i].first = (static_cast<uint64_t>(32 - rounds[i]) << 32) | hilbertIndex(x, y);
+			keys[i].second = order[i];
+		}
+	});
+	parallelSort(_pool, keys.begin(), keys.end(), [](const std::pair<uint64_t, uint32_t> & left, const std::pair<uint64_t, uint32_t> & right) {
+		return left < right;
+	});
+
+	for (size_t i = 0; i < keys.size(); ++i) {
+		order[i] = keys[i].second;
+	}
+	return order;
+}
+
+
+uint32_t Voronoi::Triangulation::_locate(const Point & point, uint32_t start) const
+{
+	// Walk towards the point, the rotating first edge prevents cycles
+	uint32_t triangle = start;
+	for (size_t step = 0; step < _triangles.size(); ++step) {
+		const uint32_t next = _step(triangle, point, step % 3);
+		if (next == NoTriangle) {
+			return triangle;
+		}
+		triangle = next;
+	}
+
+	// The walk did not arrive in as many steps as there are triangles, scan them all
+	for (uint32_t candidate = 0; candidate < _triangles.size(); ++candidate) {
+		if (_isAlive(candidate) && _step(candidate, point, 0) == NoTriangle) {
+			return candidate;
+		}
+	}
+	throw std::logic_error("No triangle contains the point");
+}
+
+
+uint32_t Voronoi::Triangulation::_step(uint32_t triangle, const Point & point, size_t firstEdge) const
+{
+	const Triangle & current = _triangles[triangle];
+	for (size_t k = 0; k < 3; ++k) {
+		const size_t edge = (firstEdge + k) % 3;
+		const Point & begin = _points[current.vertices[Next[edge]]];
+		const Point & end = _points[current.vertices[Previous[edge]]];
+		if (current.neighbours[edge] != NoTriangle && orientation(begin, end, point) < 0.0) {
+			return current.neighbours[edge];
+		}
+	}
+	return NoTriangle;
+}
+
+
+void Voronoi::Triangulation::_insert(uint32_t site)
+{
+	const Point & point = _points[site];
+	const uint32_t start = _locate(point, _last);
+	for (uint32_t vertex : _triangles[start].vertices) {
+		if (_points[vertex] == point) {
+			return;  // duplicate site
+		}
+	}
+
+	// Find the triangles whose circumcircle contains the site
+	++_mark;
+	_cavity.clear();
+	_cavityEdges.clear();
+	_cavity.push_back(start);
+	_marks[start] = _mark;
+	for (size_t i = 0; i < _cavity.size(); ++i) {
+		const Triangle & triangle = _triangles[_cavity[i]];
+		for (int k = 0; k < 3; ++k) {
+			const uint32_t neighbour = triangle.neighbours[k];
+			if (neighbour != NoTriangle && _marks[neighbour] == _mark) {
+				continue;
+			}
+			if (neighbour != NoTriangle) {
+				const auto & vertices = _triangles[neighbour].vertices;
+				if (inCircle(_points[vertices[0]], _points[vertices[1]], _points[vertices[2]], point) > 0.0) {
+					_marks[neighbour] = _mark;
+					_cavity.push_back(neighbour);
+					continue;
+				}
+			}
+			_cavityEdges.push_back(CavityEdge{ triangle.vertices[Next[k]], triangle.vertices[Previous[k]], neighbour });
+		}
+	}
+
+	// Connect the site with the edges of the cavity, the cavity triangles are reused first
+	for (uint32_t triangle : _cavity) {
+		_triangles[triangle].vertices[0] = NoVertex;
+		_freeTriangles.push_back(triangle);
+	}
+	_created.resize(_cavityEdges.size());
+	for (size_t i = 0; i < _cavityEdges.size(); ++i) {
+		const CavityEdge & edge = _cavityEdges[i];
+		uint32_t triangle;
+		if (!_freeTriangles.empty()) {
+			triangle = _freeTriangles.back();
+			_freeTriangles.pop_back();
+		}
+		else {
+			triangle = static_cast<uint32_t>(_triangles.size());
+			_triangles.emplace_back();
+			_marks.push_back(0);
+		}
+		_triangles[triangle] = Triangle{ { site, edge.begin, edge.end }, { edge.outside, NoTriangle, NoTriangle } };
+		_created[i] = triangle;
+
+		// The outside triangle is matched by the edge, the indices of the cavity are reused
+		if (edge.outside != NoTriangle) {
+			Triangle & outside = _triangles[edge.outside];
+			for (int k = 0; k < 3; ++k) {
+				if (outside.vertices[k] != edge.begin && outside.vertices[k] != edge.end) {
+					outside.neighbours[k] = triangle;
+				}
+			}
+		}
+	}
+
+	// The new triangles share the edges from the site, the next one begins where the previous one ends.
+	// The cavity is bounded by a cycle, each vertex begins one edge and is a key of the open addressing table.
+	size_t size = 16;
+	while (size < 2 * _created.size()) {
+		size *= 2;
+	}
+	const size_t mask = size - 1;
+	auto first = [mask] (uint32_t vertex) {
+		return static_cast<size_t>((vertex * 0x9e3779b97f4a7c15ull) >> 32) & mask;
+	};
+	_links.assign(size, Link{ NoVertex, NoTriangle });
+	for (uint32_t triangle : _created) {
+		size_t slot = first(_triangles[triangle].vertices[1]);
+		while (_links[slot].vertex != NoVertex) {
+			slot = (slot + 1) & mask;
+		}
+		_links[slot] = Link{ _triangles[triangle].vertices[1], triangle };
+	}
+	for (uint32_t triangle : _created) {
+		const uint32_t end = _triangles[triangle].vertices[2];
+		size_t slot = first(end);
+		while (_links[slot].vertex != end) {
+			slot = (slot + 1) & mask;
+		}
+		_triangles[triangle].neighbours[1] = _links[slot].triangle;
+		_triangles[_links[slot].triangle].neighbours[2] = triangle;
+	}
+	_last = _created.back();
+}
+
+
+std::list<Voronoi::Edge> Voronoi::Triangulation::getEdges() const
+{
+	// The vertices of the diagram
+	std::vector<Point> centers(_triangles.size());
+	forRange(_pool, _triangles.size(), [&](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i) {
+			if (_isAlive(static_cast<uint32_t>(i))) {
+				const auto & vertices = _triangles[i].vertices;
+				centers[i] = circumcenter(_points[vertices[0]], _points[vertices[1]], _points[vertices[2]]);
+			}
+		}
+	});
+
+	// Each Delaunay edge of two sites is dual to a Voronoi edge. The triangle on the left of
+	// the Delaunay edge from `a` to `b` holds the begin of Voronoi edge [a, b].
+	const size_t chunkCount = _pool ? 4 * _pool->size() : 1;
+	std::vector<std::vector<Edge>> chunks(chunkCount);
+	forRange(_pool, chunkCount, [&](size_t beginChunk, size_t endChunk) {
+		for (size_t chunk = beginChunk; chunk < endChunk; ++chunk) {
+			const size_t begin = _triangles.size() * chunk / chunkCount;
+			const size_t end = _triangles.size() * (chunk + 1) / chunkCount;
+			for (size_t i = begin; i < end; ++i) {
+				if (!_isAlive(static_cast<uint32_t>(i))) {
+					continue;
+				}
+				const Triangle & triangle = _triangles[i];
+				for (int k = 0; k < 3; ++k) {
+					const uint32_t left = triangle.vertices[Next[k]];
+					const uint32_t right = triangle.vertices[Previous[k]];
+					const uint32_t neighbour = triangle.neighbours[k];
+					if (!_isSite(left) || !_isSite(right) || neighbour == NoTriangle || neighbour < i) {
+						continue;
+					}
+					if (centers[i].isNull() || centers[neighbour].isNull()) {
+						continue;
+					}
+					Edge edge(left, right);
+					edge.setBegin(centers[i]);
+					edge.setEnd(centers[neighbour]);
+					if (clipEdge(edge, _boundingBox) && edge.begin() != edge.end()) {
+						chunks[chunk].push_back(edge);
+					}
+				}
+			}
+		}
+	});
+
+	std::list<Edge> edges;
+	for (const auto & chunk : chunks) {
+		edges.insert(edges.end(), chunk.begin(), chunk.end());
+	}
+	return edges;
+}
+
+
+std::vector<uint32_t> Voronoi::Triangulation::getTriangles() const
+{
+	std::vector<uint32_t> triangles;
+	for (uint32_t i = 0; i < _triangles.size(); ++i) {
+		const auto & vertices = _triangles[i].vertices;
+		if (_isAlive(i) && _isSite(vertices[0]) && _isSite(vertices[1]) && _isSite(vertices[2])) {
+			triangles.insert(triangles.end(), vertices, vertices + 3);
+		}
+	}
+	return triangles;
+}
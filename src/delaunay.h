@@ -0,0 +1,135 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2015 Lukáš Bednařík l.bednarik@gmail.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef DELAUNAY_H
+#define DELAUNAY_H
+
+#include "point.h"
+#include "edge.h"
+#include "boundingbox.h"
+#include "threadpool.h"
+#include <vector>
+#include <list>
+#include <cstdint>
+
+
+namespace Voronoi
+{
+	/// Delaunay triangulation by randomized incremental (Bowyer-Watson) insertion
+	///
+	/// The sites are inserted in biased randomized insertion order (BRIO): random rounds
+	/// of doubling size, each sorted along a Hilbert curve, so that the point location walk
+	/// stays short. The Voronoi diagram is the dual of the triangulation and `getEdges`
+	/// returns it in the same format as `Generator::getEdges`.
+	class Triangulation
+	{
+	public:
+		/// The pool runs the ordering and the dual in parallel, the insertion itself is sequential
+		Triangulation(const std::vector<Point> & sites, const BoundingBox & boundingBox = BoundingBox(),
+			ThreadPool * pool = nullptr);
+
+		/// Voronoi edges clipped to the bounding box
+		std::list<Edge> getEdges() const;
+
+		/// Return the input sites. Edges and triangles refer to them by index.
+		const std::vector<Point> & getSites() const;
+
+		/// Counter-clockwise triangles [a0, b0, c0, a1, b1, c1, ...] of the sites
+		std::vector<uint32_t> getTriangles() const;
+
+	private:
+		/// Flips the triangles of moving sites
+		friend class KineticDiagram;
+
+		/// Finds the cavity of a query point without inserting it
+		friend class NaturalNeighbourInterpolator;
+
+		/// Triangle with the neighbour across the edge opposite to each vertex
+		struct Triangle
+		{
+			uint32_t vertices[3];
+			uint32_t neighbours[3];
+		};
+
+		/// Edge of the cavity of an inserted site
+		struct CavityEdge
+		{
+			uint32_t begin;
+			uint32_t end;
+			uint32_t outside;  ///< Triangle on the other side of the edge
+		};
+
+		/// Created triangle keyed by the vertex its cavity edge begins with
+		struct Link
+		{
+			uint32_t vertex;
+			uint32_t triangle;
+		};
+
+		/// Input sites followed by the three vertices of the super triangle
+		std::vector<Point> _points;
+		std::vector<Point> _sites;
+		std::vector<Triangle> _triangles;
+		std::vector<uint32_t> _freeTriangles;
+		std::vector<uint32_t> _marks;  ///< Triangles with the current mark are in the cavity
+		uint32_t _mark;
+		std::vector<uint32_t> _cavity;
+		std::vector<CavityEdge> _cavityEdges;
+		std::vector<uint32_t> _created;  ///< Triangles created for the cavity edges
+		std::vector<Link> _links;
+		uint32_t _last;  ///< Starting triangle of the walk
+		BoundingBox _boundingBox;
+		ThreadPool * _pool;
+
+		std::vector<uint32_t> _insertionOrder() const;
+		void _insert(uint32_t site);
+		uint32_t _locate(const Point & point, uint32_t start) const;
+		/// Neighbour across the first edge from `firstEdge` separating the point, or `NoTriangle`
+		uint32_t _step(uint32_t triangle, const Point & point, size_t firstEdge) const;
+		bool _isAlive(uint32_t triangle) const;
+		bool _isSite(uint32_t vertex) const;
+	};
+}
+
+
+// Implementation
+
+inline const std::vector<Voronoi::Point> & Voronoi::Triangulation::getSites() const
+{
+	return _sites;
+}
+
+
+inline bool Voronoi::Triangulation::_isAlive(uint32_t triangle) const
+{
+	return _triangles[triangle].vertices[0] != NoVertex;
+}
+
+
+inline bool Voronoi::Triangulation::_isSite(uint32_t vertex) const
+{
+	return vertex < _sites.size();
+}
+
+
+#endif  // DELAUNAY_H
@@ -0,0 +1,267 @@
+#include "diagramdiff.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+
+namespace
+{
+	const uint32_t NoEdge = 0xffffffff;
+
+
+	/// Ids of the sites of an edge, the smaller first
+	struct SitePair
+	{
+		uint64_t First;
+		uint64_t Second;
+
+		bool operator==(const SitePair & other) const
+		{
+			return First == other.First && Second == other.Second;
+		}
+	};
+
+
+	uint64_t mix(uint64_t hash)
+	{
+		hash ^= hash >> 33;
+		hash *= 0xff51afd7ed558ccdull;
+		return hash ^ (hash >> 33);
+	}
+
+
+	/// Smallest power of two with at least twice as many slots as the items
+	size_t tableSize(size_t count)
+	{
+		size_t size = 16;
+		while (size < 2 * count) {
+			size *= 2;
+		}
+		return size;
+	}
+
+
+	/// Open addressing table of the previous edges, several edges may have the same sites
+	class EdgeTable
+	{
+	public:
+		explicit EdgeTable(size_t count) :
+			_slots(tableSize(count), Slot{ SitePair{ 0, 0 }, NoEdge }),
+			_mask(_slots.size() - 1)
+		{
+		}
+
+		void insert(const SitePair & sites, uint32_t edge)
+		{
+			size_t slot = _first(sites);
+			while (_slots[slot].Edge != NoEdge) {
+				slot = (slot + 1) & _mask;
+			}
+			_slots[slot] = Slot{ sites, edge };
+		}
+
+		/// Call `function(edge)` for the edges of the sites until it returns true
+		template <typename Function>
+		void find(const SitePair & sites, Function function) const
+		{
+			for (size_t slot = _first(sites); _slots[slot].Edge != NoEdge; slot = (slot + 1) & _mask) {
+				if (_slots[slot].Sites == sites && function(_slots[slot].Edge)) {
+					return;
+				}
+			}
+		}
+
+	private:
+		struct Slot
+		{
+			SitePair Sites;
+			uint32_t Edge;
+		};
+
+		std::vector<Slot> _slots;
+		size_t _mask;
+
+		size_t _first(const SitePair & sites) const
+		{
+			return static_cast<size_t>(mix(sites.First * 0x9e3779b97f4a7c15ull + sites.Second)) & _mask;
+		}
+	};
+
+
+	/// Open addressing set of the site ids of the differing edges, with the versions they have edges in
+	class CellTable
+	{
+	public:
+		static const uint8_t Before = 1;
+		static const uint8_t After = 2;
+
+		explicit CellTable(const std::vector<uint64_t> & ids) :
+			_slots(tableSize(ids.size()), Slot{ 0, 0, false }),
+			_mask(_slots.size() - 1)
+		{
+			for (uint64_t id : ids) {
+				_slots[_find(id)] = Slot{ id, 0, true };
+			}
+		}
+
+		/// Add the flags to the id if it is in the set
+		void mark(uint64_t id, uint8_t flags)
+		{
+			Slot & slot = _slots[_find(id)];
+			if (slot.IsUsed) {
+				slot.Flags |= flags;
+			}
+		}
+
+		/// Call `function(id, flags)` for all ids
+		template <typename Function>
+		void forEach(Function function) const
+		{
+			for (const Slot & slot : _slots) {
+				if (slot.IsUsed) {
+					function(slot.Id, slot.Flags);
+				}
+			}
+		}
+
+	private:
+		struct Slot
+		{
+			uint64_t Id;
+			uint8_t Flags;
+			bool IsUsed;
+		};
+
+		std::vector<Slot> _slots;
+		size_t _mask;
+
+		/// Slot of the id or the empty slot where it belongs
+		size_t _find(uint64_t id) const
+		{
+			size_t slot = static_cast<size_t>(mix(id)) & _mask;
+			while (_slots[slot].IsUsed && _slots[slot].Id != id) {
+				slot = (slot + 1) & _mask;
+			}
+			return slot;
+		}
+	};
+
+
+	bool samePoint(const Voronoi::Point & left, const Voronoi::Point & right, double tolerance)
+	{
+		if (left.isNull() || right.isNull()) {
+			return left.isNull() && right.isNull();
+		}
+		return std::fabs(left.x() - right.x()) <= tolerance && std::fabs(left.y() - right.y()) <= tolerance;
+	}
+
+
+	/// Compare the edges oriented from the site with the smaller id
+	bool sameEnds(const Voronoi::Edge & left, bool isLeftReversed, const Voronoi::Edge & right, bool isRightReversed,
+		double tolerance)
+	{
+		const Voronoi::Point leftBegin = isLeftReversed ? left.end() : left.begin();
+		const Voronoi::Point leftEnd = isLeftReversed ? left.begin() : left.end();
+		const Voronoi::Point rightBegin = isRightReversed ? right.end() : right.begin();
+		const Voronoi::Point rightEnd = isRightReversed ? right.begin() : right.end();
+		return samePoint(leftBegin, rightBegin, tolerance) && samePoint(leftEnd, rightEnd, tolerance);
+	}
+
+
+	uint64_t siteId(const std::vector<uint64_t> * ids, uint32_t site)
+	{
+		if (!ids) {
+			return site;
+		}
+		if (site >= ids->size()) {
+			throw std::out_of_range("DiagramDiff: Edge refers to a site without an id!");
+		}
+		return (*ids)[site];
+	}
+}  // end of anonymous namespace
+
+
+void Voronoi::DiagramDiff::_compare(const std::vector<const Edge *> & before, const std::vector<uint64_t> * beforeIds,
+	const std::vector<const Edge *> & after, const std::vector<uint64_t> * afterIds, double tolerance)
+{
+	EdgeTable previous(before.size());
+	std::vector<bool> isReversed(before.size());
+	for (uint32_t i = 0; i < before.size(); ++i) {
+		const uint64_t left = siteId(beforeIds, before[i]->leftSite());
+		const uint64_t right = siteId(beforeIds, before[i]->rightSite());
+		previous.insert(SitePair{ std::min(left, right), std::max(left, right) }, i);
+		isReversed[i] = left > right;
+	}
+
+	// Match the new edges, an unchanged one is preferred among the edges of the same sites
+	std::vector<bool> isMatched(before.size(), false);
+	std::vector<uint64_t> touchedCells;
+	for (const Edge * edge : after) {
+		const uint64_t left = siteId(afterIds, edge->leftSite());
+		const uint64_t right = siteId(afterIds, edge->rightSite());
+		uint32_t match = NoEdge;
+		bool isSame = false;
+		previous.find(SitePair{ std::min(left, right), std::max(left, right) }, [&](uint32_t candidate) {
+			if (isMatched[candidate]) {
+				return false;
+			}
+			if (match == NoEdge) {
+				match = candidate;
+			}
+			if (sameEnds(*before[candidate], isReversed[candidate], *edge, left > right, tolerance)) {
+				match = candidate;
+				isSame = true;
+			}
+			return isSame;
+		});
+
+		if (match != NoEdge) {
+			isMatched[match] = true;
+			if (isSame) {
+				continue;
+			}
+			_changedEdges.push_back(*edge);
+		}
+		else {
+			_addedEdges.push_back(*edge);
+		}
+		touchedCells.push_back(left);
+		touchedCells.push_back(right);
+	}
+
+	for (size_t i = 0; i < before.size(); ++i) {
+		if (!isMatched[i]) {
+			_removedEdges.push_back(*before[i]);
+			touchedCells.push_back(siteId(beforeIds, before[i]->leftSite()));
+			touchedCells.push_back(siteId(beforeIds, before[i]->rightSite()));
+		}
+	}
+	if (touchedCells.empty()) {
+		return;
+	}
+
+	// The cells of the differing edges are looked up in a small table, which stays in the cache
+	CellTable cells(touchedCells);
+	for (const Edge * edge : before) {
+		cells.mark(siteId(beforeIds, edge->leftSite()), CellTable::Before);
+		cells.mark(siteId(beforeIds, edge->rightSite()), CellTable::Before);
+	}
+	for (const Edge * edge : after) {
+		cells.mark(siteId(afterIds, edge->leftSite()), CellTable::After);
+		cells.mark(siteId(afterIds, edge->rightSite()), CellTable::After);
+	}
+	cells.forEach([this](uint64_t id, uint8_t flags) {
+		if ((flags & CellTable::Before) && (flags & CellTable::After)) {
+			_changedCells.push_back(id);
+		}
+		else if (flags & CellTable::After) {
+			_addedCells.push_back(id);
+		}
+		else {
+			_removedCells.push_back(id);
+		}
+	});
+	std::sort(_addedCells.begin(), _addedCells.end());
+	std::sort(_removedCells.begin(), _removedCells.end());
+	std::sort(_changedCells.begin(), _changedCells.end());
+}
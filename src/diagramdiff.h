@@ -0,0 +1,159 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2015 Lukáš Bednařík l.bednarik@gmail.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+#ifndef DIAGRAMDIFF_H
+#define DIAGRAMDIFF_H
+
+#include "edge.h"
+#include <vector>
+#include <cstdint>
+
+
+namespace Voronoi
+{
+	/// Changes between two versions of a diagram, the sites are matched by their ids
+	///
+	/// Edges are keyed by the unordered pair of ids of their sites and looked up in a hash table,
+	/// so the comparison takes expected linear time. An edge between the same sites in both versions
+	/// is changed if any of its ends moved by more than the tolerance. A cell is added or removed if
+	/// its site has edges in one version only and changed if any of its edges differ.
+	///
+	/// Without the ids a site is identified by its index. The edges of the result refer to the sites
+	/// of their own version: added and changed edges to `after`, removed edges to `before`.
+	class DiagramDiff
+	{
+	public:
+		template <typename BeforeEdges, typename AfterEdges>
+		DiagramDiff(const BeforeEdges & before, const AfterEdges & after, double tolerance = 0.0);
+
+		/// `beforeIds[site]` is the id of a site of `before`, the same for `after`
+		template <typename BeforeEdges, typename AfterEdges>
+		DiagramDiff(const BeforeEdges & before, const std::vector<uint64_t> & beforeIds, const AfterEdges & after,
+			const std::vector<uint64_t> & afterIds, double tolerance = 0.0);
+
+		/// Edges between the sites which became neighbours
+		const std::vector<Edge> & addedEdges() const;
+
+		/// Edges between the sites which are not neighbours any more
+		const std::vector<Edge> & removedEdges() const;
+
+		/// New version of the edges which moved
+		const std::vector<Edge> & changedEdges() const;
+
+		/// Sorted ids of the sites
+		const std::vector<uint64_t> & addedCells() const;
+		const std::vector<uint64_t> & removedCells() const;
+		const std::vector<uint64_t> & changedCells() const;
+
+		/// True if the diagrams are the same
+		bool isEmpty() const;
+
+	private:
+		std::vector<Edge> _addedEdges;
+		std::vector<Edge> _removedEdges;
+		std::vector<Edge> _changedEdges;
+		std::vector<uint64_t> _addedCells;
+		std::vector<uint64_t> _removedCells;
+		std::vector<uint64_t> _changedCells;
+
+		template <typename Edges>
+		static std::vector<const Edge *> _pointers(const Edges & edges);
+
+		void _compare(const std::vector<const Edge *> & before, const std::vector<uint64_t> * beforeIds,
+			const std::vector<const Edge *> & after, const std::vector<uint64_t> * afterIds, double tolerance);
+	};
+}
+
+
+// Implementation
+
+template <typename BeforeEdges, typename AfterEdges>
+Voronoi::DiagramDiff::DiagramDiff(const BeforeEdges & before, const AfterEdges & after, double tolerance)
+{
+	_compare(_pointers(before), nullptr, _pointers(after), nullptr, tolerance);
+}
+
+
+template <typename BeforeEdges, typename AfterEdges>
+Voronoi::DiagramDiff::DiagramDiff(const BeforeEdges & before, const std::vector<uint64_t> & beforeIds,
+	const AfterEdges & after, const std::vector<uint64_t> & afterIds, double tolerance)
+{
+	_compare(_pointers(before), &beforeIds, _pointers(after), &afterIds, tolerance);
+}
+
+
+inline const std::vector<Voronoi::Edge> & Voronoi::DiagramDiff::addedEdges() const
+{
+	return _addedEdges;
+}
+
+
+inline const std::vector<Voronoi::Edge> & Voronoi::DiagramDiff::removedEdges() const
+{
+	return _removedEdges;
+}
+
+
+inline const std::vector<Voronoi::Edge> & Voronoi::DiagramDiff::changedEdges() const
+{
+	return _changedEdges;
+}
+
+
+inline const std::vector<uint64_t> & Voronoi::DiagramDiff::addedCells() const
+{
+	return _addedCells;
+}
+
+
+inline const std::vector<uint64_t> & Voronoi::DiagramDiff::removedCells() const
+{
+	return _removedCells;
+}
+
+
+inline const std::vector<uint64_t> & Voronoi::DiagramDiff::changedCells() const
+{
+	return _changedCells;
+}
+
+
+inline bool Voronoi::DiagramDiff::isEmpty() const
+{
+	return _addedEdges.empty() && _removedEdges.empty() && _changedEdges.empty();
+}
+
+
+template <typename Edges>
+std::vector<const Voronoi::Edge *> Voronoi::DiagramDiff::_pointers(const Edges & edges)
+{
+	std::vector<const Edge *> pointers;
+	for (const Edge & edge : edges) {
+		pointers.push_back(&edge);
+	}
+	return pointers;
+}
+
+
+#endif  // DIAGRAMDIFF_H
@@ -26,39 +26,50 @@
 
 #include "point.h"
 #include <utility>
+#include <cstdint>
 
 
 namespace Voronoi
 {
+	/// Vertex index of an edge end which is not a vertex of the diagram
+	const uint32_t NoVertex = 0xffffffff;
+
+
 	/// Edge class stores an edge in Voronoi diagram
+	///
+	/// Sites are referred by their index in the input vector of sites.
+	/// Ends which are vertices of the diagram also store the vertex index.
 	class Edge
 	{
 	public:
-		Edge(const Point & left, const Point & right);
+		Edge(uint32_t leftSite, uint32_t rightSite);
 		Point begin() const;
 		Point end() const;
-		Point left() const;
-		Point right() const;
-		void setBegin(const Point & begin);
-		void setEnd(const Point & end);
-
-		Edge * twin;  ///< some edges consist of two parts, so we add the pointer to another part to connect them at the end of an algorithm
+		uint32_t leftSite() const;
+		uint32_t rightSite() const;
+		uint32_t beginVertex() const;
+		uint32_t endVertex() const;
+		void setBegin(const Point & begin, uint32_t vertex = NoVertex);
+		void setEnd(const Point & end, uint32_t vertex = NoVertex);
 
 	private:
-		Point _begin;  ///< Start of the edge
-		Point _end;    ///< End of the edge
-		Point _left;   ///< Each edge lies between two points, this is the left
-		Point _right;  ///< Each edge lies between two points, this is the right
+		Point _begin;         ///< Start of the edge
+		Point _end;           ///< End of the edge
+		uint32_t _leftSite;   ///< Each edge lies between two sites, this is the left
+		uint32_t _rightSite;  ///< Each edge lies between two sites, this is the right
+		uint32_t _beginVertex;
+		uint32_t _endVertex;
 	};
 }
 
 
 // Implementation
 
-inline Voronoi::Edge::Edge(const Point & left, const Point & right) :
-	twin(nullptr),
-	_left(left),
-	_right(right)
+inline Voronoi::Edge::Edge(uint32_t leftSite, uint32_t rightSite) :
+	_leftSite(leftSite),
+	_rightSite(rightSite),
+	_beginVertex(NoVertex),
+	_endVertex(NoVertex)
 {
 }
 
@@ -75,27 +86,41 @@ inline Voronoi::Point Voronoi::Edge::end() const
 }
 
 
-inline Voronoi::Point Voronoi::Edge::left() const
+inline uint32_t Voronoi::Edge::leftSite() const
+{
+	return _leftSite;
+}
+
+
+inline uint32_t Voronoi::Edge::rightSite() const
+{
+	return _rightSite;
+}
+
+
+inline uint32_t Voronoi::Edge::beginVertex() const
 {
-	return _left;
+	return _beginVertex;
 }
 
 
-inline Voronoi::Point Voronoi::Edge::right() const
+inline uint32_t Voronoi::Edge::endVertex() const
 {
-	return _right;
+	return _endVertex;
 }
 
 
-inline void Voronoi::Edge::setBegin(const Point & begin)
+inline void Voronoi::Edge::setBegin(const Point & begin, uint32_t vertex)
 {
 	_begin = begin;
+	_beginVertex = vertex;
 }
 
 
-inline void Voronoi::Edge::setEnd(const Point & end)
+inline void Voronoi::Edge::setEnd(const Point & end, uint32_t vertex)
 {
 	_end = end;
+	_endVertex = vertex;
 }
 
 
@@ -0,0 +1,64 @@
+#include "edgegrid.h"
+#include <cmath>
+
+
+Voronoi::EdgeGrid::EdgeGrid(MemoryResource * resource) :
+	_edges(nullptr),
+	_cellStarts(resource),
+	_cellEdges(resource),
+	_unboundedEdges(resource),
+	_columns(0),
+	_rows(0),
+	_columnsPerUnit(0.0),
+	_rowsPerUnit(0.0)
+{
+}
+
+
+void Voronoi::EdgeGrid::build(const Edge * edges, size_t count, const BoundingBox & extent)
+{
+	_edges = edges;
+	_extent = extent;
+	_unboundedEdges.clear();
+	_cellEdges.clear();
+	size_t boundedCount = 0;
+	for (uint32_t i = 0; i < count; ++i) {
+		if (edges[i].begin().isNull() || edges[i].end().isNull()) {
+			_unboundedEdges.push_back(i);
+		}
+		else {
+			++boundedCount;
+		}
+	}
+	if (boundedCount == 0) {
+		_columns = 0;
+		_rows = 0;
+		_cellStarts.assign(1, 0);
+		return;
+	}
+
+	// About two edges per cell, the edges of a diagram are short
+	const size_t side = std::max<size_t>(1, static_cast<size_t>(std::sqrt(boundedCount / 2.0)));
+	_columns = (_extent.MaxX > _extent.MinX) ? side : 1;
+	_rows = (_extent.MaxY > _extent.MinY) ? side : 1;
+	_columnsPerUnit = (_extent.MaxX > _extent.MinX) ? side / (_extent.MaxX - _extent.MinX) : 0.0;
+	_rowsPerUnit = (_extent.MaxY > _extent.MinY) ? side / (_extent.MaxY - _extent.MinY) : 0.0;
+
+	// Count the edges of the cells, then fill them in
+	_cellStarts.assign(_columns * _rows + 1, 0);
+	for (uint32_t i = 0; i < count; ++i) {
+		if (!edges[i].begin().isNull() && !edges[i].end().isNull()) {
+			_forCells(edges[i], [this](size_t cell) { ++_cellStarts[cell + 1]; });
+		}
+	}
+	for (size_t cell = 0; cell < _columns * _rows; ++cell) {
+		_cellStarts[cell + 1] += _cellStarts[cell];
+	}
+	_cellEdges.resize(_cellStarts.back());
+	IndexVector cursors(_cellStarts.begin(), _cellStarts.end() - 1, _cellStarts.get_allocator());
+	for (uint32_t i = 0; i < count; ++i) {
+		if (!edges[i].begin().isNull() && !edges[i].end().isNull()) {
+			_forCells(edges[i], [this, &cursors, i](size_t cell) { _cellEdges[cursors[cell]++] = i; });
+		}
+	}
+}
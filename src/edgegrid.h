@@ -0,0 +1,149 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2015 Lukáš Bednařík l.bednarik@gmail.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+#ifndef EDGEGRID_H
+#define EDGEGRID_H
+
+#include "edge.h"
+#include "boundingbox.h"
+#include "memoryresource.h"
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+
+namespace Voronoi
+{
+	/// Uniform grid of the edges binned by their bounding boxes
+	///
+	/// Edges with both ends are binned into all cells overlapped by their bounding box. The cells
+	/// cover the given extent and the edges beyond it fall into the border cells, so the few far
+	/// vertices of a diagram don't make the cells coarse.
+	/// Edges with a missing end are rays or lines and they are kept aside, every query
+	/// returns them. The queries don't change the grid, so they can run in parallel.
+	class EdgeGrid
+	{
+	public:
+		explicit EdgeGrid(MemoryResource * resource = newDeleteResource());
+
+		/// Bin the edges over the extent, they must stay in place while the grid is used
+		void build(const Edge * edges, size_t count, const BoundingBox & extent);
+
+		/// Call `function(index)` once for every edge which may cross the box
+		template <typename Function>
+		void query(const BoundingBox & boundingBox, Function function) const;
+
+	private:
+		typedef std::vector<uint32_t, Allocator<uint32_t>> IndexVector;
+
+		const Edge * _edges;
+		IndexVector _cellStarts;   ///< Edges of cell `i` are `_cellEdges[_cellStarts[i]]` up to the next start
+		IndexVector _cellEdges;
+		IndexVector _unboundedEdges;
+		BoundingBox _extent;       ///< Box covered by the cells
+		size_t _columns;
+		size_t _rows;
+		double _columnsPerUnit;
+		double _rowsPerUnit;
+
+		size_t _column(double x) const;
+		size_t _row(double y) const;
+
+		/// Call `function(cell)` for the cells overlapped by the bounding box of the edge
+		template <typename Function>
+		void _forCells(const Edge & edge, Function function) const;
+	};
+}
+
+
+// Implementation
+
+template <typename Function>
+void Voronoi::EdgeGrid::query(const BoundingBox & boundingBox, Function function) const
+{
+	for (uint32_t edge : _unboundedEdges) {
+		function(edge);
+	}
+	if (_columns == 0) {
+		return;
+	}
+
+	// An edge in several cells is reported by the first of them within the queried range
+	const size_t firstColumn = _column(boundingBox.MinX);
+	const size_t lastColumn = _column(boundingBox.MaxX);
+	const size_t firstRow = _row(boundingBox.MinY);
+	const size_t lastRow = _row(boundingBox.MaxY);
+	for (size_t row = firstRow; row <= lastRow; ++row) {
+		for (size_t column = firstColumn; column <= lastColumn; ++column) {
+			const size_t cell = row * _columns + column;
+			for (uint32_t i = _cellStarts[cell]; i < _cellStarts[cell + 1]; ++i) {
+				const Edge & edge = _edges[_cellEdges[i]];
+				const size_t edgeColumn = _column(std::min(edge.begin().x(), edge.end().x()));
+				const size_t edgeRow = _row(std::min(edge.begin().y(), edge.end().y()));
+				if (std::max(edgeColumn, firstColumn) == column && std::max(edgeRow, firstRow) == row) {
+					function(_cellEdges[i]);
+				}
+			}
+		}
+	}
+}
+
+
+template <typename Function>
+void Voronoi::EdgeGrid::_forCells(const Edge & edge, Function function) const
+{
+	const size_t firstColumn = _column(std::min(edge.begin().x(), edge.end().x()));
+	const size_t lastColumn = _column(std::max(edge.begin().x(), edge.end().x()));
+	const size_t firstRow = _row(std::min(edge.begin().y(), edge.end().y()));
+	const size_t lastRow = _row(std::max(edge.begin().y(), edge.end().y()));
+	for (size_t row = firstRow; row <= lastRow; ++row) {
+		for (size_t column = firstColumn; column <= lastColumn; ++column) {
+			function(row * _columns + column);
+		}
+	}
+}
+
+
+inline size_t Voronoi::EdgeGrid::_column(double x) const
+{
+	const double column = (x - _extent.MinX) * _columnsPerUnit;
+	if (column <= 0.0) {
+		return 0;
+	}
+	return column < static_cast<double>(_columns) ? static_cast<size_t>(column) : _columns - 1;
+}
+
+
+inline size_t Voronoi::EdgeGrid::_row(double y) const
+{
+	const double row = (y - _extent.MinY) * _rowsPerUnit;
+	if (row <= 0.0) {
+		return 0;
+	}
+	return row < static_cast<double>(_rows) ? static_cast<size_t>(row) : _rows - 1;
+}
+
+
+#endif  // EDGEGRID_H
@@ -0,0 +1,49 @@
+#include "engine.h"
+#include "voronoi.h"
+#include "delaunay.h"
+#include "smallgenerator.h"
+#include "geometry.h"
+#include <stdexcept>
+
+
+Voronoi::Engine Voronoi::engineFromName(const std::string & name)
+{
+	if (name == "fortune") {
+		return Engine::Fortune;
+	}
+	if (name == "delaunay") {
+		return Engine::Delaunay;
+	}
+	throw std::domain_error("Unknown engine " + name);
+}
+
+
+void Voronoi::generateEdges(const std::vector<Point> & sites, std::vector<Edge> & edges, const BoundingBox & boundingBox,
+	Engine engine, ThreadPool * pool)
+{
+	edges.clear();
+	switch (engine) {
+	case Engine::Fortune:
+		if (sites.size() <= SmallSiteCount && !boundingBox.Periodic) {
+			const SmallGenerator<SmallSiteCount> generator(sites, boundingBox);
+			edges.assign(generator.getEdges().begin(), generator.getEdges().end());
+		}
+		else {
+			// The sweep keeps the edges of the vertices outside of the box, `SmallGenerator` doesn't
+			const Generator generator(sites, boundingBox);
+			for (Edge edge : generator.getEdges()) {
+				if (clipEdge(edge, boundingBox) && edge.begin() != edge.end()) {
+					edges.push_back(edge);
+				}
+			}
+		}
+		return;
+	case Engine::Delaunay:
+		{
+			const auto triangulationEdges = Triangulation(sites, boundingBox, pool).getEdges();
+			edges.assign(triangulationEdges.begin(), triangulationEdges.end());
+		}
+		return;
+	}
+	throw std::domain_error("Unknown engine");
+}
@@ -0,0 +1,58 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2015 Lukáš Bednařík l.bednarik@gmail.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef ENGINE_H
+#define ENGINE_H
+
+#include "point.h"
+#include "edge.h"
+#include "boundingbox.h"
+#include "threadpool.h"
+#include <vector>
+#include <string>
+
+
+namespace Voronoi
+{
+	/// Algorithm computing the diagram
+	enum class Engine
+	{
+		Fortune,   ///< Sweep line, `Generator`, or `SmallGenerator` for a few sites
+		Delaunay,  ///< Dual of the incremental triangulation, `Triangulation`, sequential insertion
+	};
+
+	/// Return the engine called `name` ("fortune" or "delaunay")
+	Engine engineFromName(const std::string & name);
+
+	/// Compute the edges of the diagram with the chosen engine into `edges`
+	///
+	/// The edges are clipped to the bounding box by all engines. The pool is used by the Delaunay
+	/// engine for the ordering of the sites and for the dual, the insertion between them is
+	/// sequential. Up to `SmallSiteCount` sites the Fortune engine is replaced by `SmallGenerator`,
+	/// which makes no allocation once `edges` has grown big enough.
+	void generateEdges(const std::vector<Point> & sites, std::vector<Edge> & edges,
+		const BoundingBox & boundingBox = BoundingBox(), Engine engine = Engine::Fortune, ThreadPool * pool = nullptr);
+}
+
+
+#endif  // ENGINE_H
@@ -25,22 +25,22 @@
 #define EVENT_H
 
 #include "point.h"
+#include <memory>
+#include <cstdint>
 
 
 namespace Voronoi
 {
-	class ParabolaNode;
-
-
 	/// Simple site event triggered by input point
 	class SiteEvent
 	{
 	public:
-		SiteEvent(const Point & site);
-		bool operator>(const SiteEvent & other) const;
-		Point site() const;
+		explicit SiteEvent(uint32_t site);
+
+		/// Index of the site
+		uint32_t site() const;
 	private:
-		Point _site;
+		uint32_t _site;
 	};
 
 
@@ -52,11 +52,11 @@ namespace Voronoi
 
 		Point site() const;
 
-		/// Set parabola for this event
-		void setParabolaNode(ParabolaNode * parabolaNode);
+		/// Set parabola (beachline index) for this event
+		void setParabolaNode(uint32_t parabolaNode);
 
-		/// Get parabola for this event
-		ParabolaNode * parabolaNode();
+		/// Get parabola (beachline index) for this event
+		uint32_t parabolaNode() const;
 
 		/// Set circumcenter for this vertex event
 		void setCircumcenter(const Point & circumcenter);
@@ -73,29 +73,31 @@ namespace Voronoi
 	private:
 		Point _site;
 		bool _isDisabled;
-		ParabolaNode * _parabolaNode;
+		uint32_t _parabolaNode;
 		Point _circumcenter;
 	};
 
 
-	inline bool operator>(const SiteEvent & left, const SiteEvent & right) { return left.operator>(right); }
+	/// Order of vertex events in a priority queue. The event with the biggest "y" is on the top.
+	struct VertexEventCompare
+	{
+		template <typename Pointer>
+		bool operator()(const Pointer & left, const Pointer & right) const
+		{
+			return left->site() < right->site();
+		}
+	};
 }
 
 
 // Implementation
-inline Voronoi::SiteEvent::SiteEvent(const Point & site) :
+inline Voronoi::SiteEvent::SiteEvent(uint32_t site) :
 	_site(site)
 {
 }
 
 
-inline bool Voronoi::SiteEvent::operator>(const SiteEvent & other) const
-{
-	return _site > other._site;
-}
-
-
-inline Voronoi::Point Voronoi::SiteEvent::site() const
+inline uint32_t Voronoi::SiteEvent::site() const
 {
 	return _site;
 }
@@ -103,8 +105,8 @@ inline Voronoi::Point Voronoi::SiteEvent::site() const
 
 inline Voronoi::VertexEvent::VertexEvent(const Point & site) :
 	_site(site),
-	_parabolaNode(nullptr),
-	_isDisabled(false)
+	_isDisabled(false),
+	_parabolaNode(0xffffffff)
 {
 }
 
@@ -127,13 +129,13 @@ inline void Voronoi::VertexEvent::disable()
 }
 
 
-inline void Voronoi::VertexEvent::setParabolaNode(ParabolaNode * parabolaNode)
+inline void Voronoi::VertexEvent::setParabolaNode(uint32_t parabolaNode)
 {
 	_parabolaNode = parabolaNode;
 }
 
 
-inline Voronoi::ParabolaNode * Voronoi::VertexEvent::parabolaNode()
+inline uint32_t Voronoi::VertexEvent::parabolaNode() const
 {
 	return _parabolaNode;
 }
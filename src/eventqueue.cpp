@@ -0,0 +1,151 @@
+#include "eventqueue.h"
+#include <algorithm>
+
+
+namespace
+{
+	const uint32_t NoNode = 0xffffffff;
+
+	/// Longer buckets mean the events are not spread evenly, the heap is faster then
+	const size_t MaxBucketLength = 32;
+}  // end of anonymous namespace
+
+
+Voronoi::VertexEventQueue::VertexEventQueue(MemoryResource * resource) :
+	_resource(resource),
+	_nodes(resource),
+	_freeNodes(NoNode),
+	_buckets(resource),
+	_size(0),
+	_current(0),
+	_top(0.0),
+	_bottom(0.0),
+	_bucketsPerUnit(0.0),
+	_isCalendar(false),
+	_heap(VertexEventCompare(), std::vector<VertexEventPointer, Allocator<VertexEventPointer>>(resource)),
+	_freeEvents(resource)
+{
+}
+
+
+void Voronoi::VertexEventQueue::reset(double top, double bottom, size_t bucketCount)
+{
+	_nodes.clear();
+	_freeNodes = NoNode;
+	_buckets.assign(bucketCount, NoNode);
+	_size = 0;
+	_current = 0;
+	_top = top;
+	_bottom = bottom;
+	_statistics = EventStatistics();
+	_isCalendar = bucketCount > 0 && top > bottom;
+	_bucketsPerUnit = _isCalendar ? bucketCount / (top - bottom) : 0.0;
+	while (!_heap.empty()) {
+		_heap.pop();
+	}
+}
+
+
+void Voronoi::VertexEventQueue::push(VertexEventPointer event)
+{
+	const double y = event->site().y();
+	if (!_isCalendar || y < _bottom) {
+		_heap.push(std::move(event));
+		return;
+	}
+
+	// The current bucket is the first non-empty one. New events are below the sweepline,
+	// so it moves back by the gap between the sweepline and the next event at most.
+	const size_t bucket = (y >= _top) ? 0 : std::min(static_cast<size_t>((_top - y) * _bucketsPerUnit), _buckets.size() - 1);
+	if (_size == 0 || bucket < _current) {
+		_current = bucket;
+	}
+
+	uint32_t node = _freeNodes;
+	if (node != NoNode) {
+		_freeNodes = _nodes[node].next;
+	}
+	else {
+		node = static_cast<uint32_t>(_nodes.size());
+		_nodes.emplace_back();
+	}
+	_nodes[node].event = std::move(event);
+
+	// Keep the top event first
+	uint32_t & head = _buckets[bucket];
+	if (head == NoNode || _nodes[head].event->site() < _nodes[node].event->site()) {
+		_nodes[node].next = head;
+		head = node;
+	}
+	else {
+		_nodes[node].next = _nodes[head].next;
+		_nodes[head].next = node;
+	}
+	++_size;
+}
+
+
+Voronoi::VertexEventPointer Voronoi::VertexEventQueue::pop()
+{
+	if (top()->isDisabled()) {
+		++_statistics.Disabled;
+	}
+	if (_size == 0) {
+		// The top is const, the event is moved out of it just before it's removed
+		auto event = std::move(const_cast<VertexEventPointer &>(_heap.top()));
+		_heap.pop();
+		return event;
+	}
+
+	uint32_t & head = _buckets[_current];
+	const uint32_t node = head;
+	head = _nodes[node].next;
+	auto event = std::move(_nodes[node].event);
+	_nodes[node].next = _freeNodes;
+	_freeNodes = node;
+	--_size;
+
+	if (head != NoNode) {
+		// Move the new top event to the front
+		uint32_t best = head;
+		uint32_t beforeBest = NoNode;
+		size_t length = 1;
+		for (uint32_t previous = head, it = _nodes[head].next; it != NoNode; previous = it, it = _nodes[it].next) {
+			++length;
+			if (_nodes[best].event->site() < _nodes[it].event->site()) {
+				best = it;
+				beforeBest = previous;
+			}
+		}
+		if (beforeBest != NoNode) {
+			_nodes[beforeBest].next = _nodes[best].next;
+			_nodes[best].next = head;
+			head = best;
+		}
+		if (length > MaxBucketLength) {
+			_fallback();
+		}
+	}
+	else if (_size > 0) {
+		while (_buckets[_current] == NoNode) {
+			++_current;
+		}
+	}
+	return event;
+}
+
+
+void Voronoi::VertexEventQueue::_fallback()
+{
+	for (size_t bucket = _current; bucket < _buckets.size(); ++bucket) {
+		for (uint32_t it = _buckets[bucket]; it != NoNode; it = _nodes[it].next) {
+			_heap.push(std::move(_nodes[it].event));
+		}
+	}
+	_nodes.clear();
+	_freeNodes = NoNode;
+	_buckets.clear();
+	_size = 0;
+	_current = 0;
+	_isCalendar = false;
+}
@@ -0,0 +1,181 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2015 Lukáš Bednařík l.bednarik@gmail.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef EVENTQUEUE_H
+#define EVENTQUEUE_H
+
+#include "event.h"
+#include "memoryresource.h"
+#include <queue>
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+
+namespace Voronoi
+{
+	/// Vertex event in the memory of the queue
+	typedef std::unique_ptr<VertexEvent, ResourceDeleter<VertexEvent>> VertexEventPointer;
+
+
+	/// Numbers of the vertex events since the last `reset` of the queue
+	struct EventStatistics
+	{
+		EventStatistics() : Created(0), Recycled(0), Disabled(0) {}
+
+		/// All events of `create`, `Recycled` of them reuse the memory of a released event
+		size_t Created;
+		size_t Recycled;
+
+		/// Popped events which had been disabled, they are skipped
+		size_t Disabled;
+	};
+
+
+	/// Priority queue of vertex events, the event with the biggest "y" is on the top
+	///
+	/// The events are kept in a calendar of buckets of equal height. The sweep moves
+	/// monotonically down, so with evenly spread events push and pop take expected constant
+	/// time. Events below the calendar go to a binary heap, which is taken after the calendar.
+	/// When a bucket gets too full (skewed input) all events move to the heap for good.
+	class VertexEventQueue
+	{
+	public:
+		/// The events and the buckets are allocated from the resource
+		explicit VertexEventQueue(MemoryResource * resource = newDeleteResource());
+
+		/// Remove all events and set up the calendar of `bucketCount` buckets in [bottom, top]
+		///
+		/// Zero buckets make a plain binary heap.
+		void reset(double top, double bottom, size_t bucketCount);
+
+		bool empty() const;
+		size_t size() const;
+
+		/// Return the event with the biggest "y"
+		VertexEvent * top() const;
+
+		/// Return a new event, the memory of released events is reused
+		VertexEventPointer create(const Point & site);
+
+		/// Keep the event for `create`, e.g. after it's popped and processed
+		void release(VertexEventPointer event);
+
+		void push(VertexEventPointer event);
+
+		/// Remove the top event and return it
+		VertexEventPointer pop();
+
+		/// Return false if the queue is a heap, either by `reset` or by the fallback
+		bool isCalendar() const;
+
+		const EventStatistics & statistics() const;
+
+	private:
+		struct Node
+		{
+			VertexEventPointer event;
+			uint32_t next;
+		};
+
+		/// Events of all buckets, the buckets are linked lists with the top event first
+		MemoryResource * _resource;
+		std::vector<Node, Allocator<Node>> _nodes;
+		uint32_t _freeNodes;
+		std::vector<uint32_t, Allocator<uint32_t>> _buckets;
+
+		/// Events in the buckets, `_current` is the first non-empty bucket
+		size_t _size;
+		size_t _current;
+
+		double _top;
+		double _bottom;
+		double _bucketsPerUnit;
+		bool _isCalendar;
+
+		std::priority_queue<VertexEventPointer, std::vector<VertexEventPointer, Allocator<VertexEventPointer>>, VertexEventCompare> _heap;
+
+		/// Released events. About 44 % of the events are disabled before they are processed,
+		/// so there are many of them (see the `Vertex events` lines of the voronoi benchmark).
+		std::vector<VertexEventPointer, Allocator<VertexEventPointer>> _freeEvents;
+
+		EventStatistics _statistics;
+
+		void _fallback();
+	};
+}
+
+
+// Implementation
+
+inline bool Voronoi::VertexEventQueue::empty() const
+{
+	return _size == 0 && _heap.empty();
+}
+
+
+inline size_t Voronoi::VertexEventQueue::size() const
+{
+	return _size + _heap.size();
+}
+
+
+inline Voronoi::VertexEvent * Voronoi::VertexEventQueue::top() const
+{
+	return _size > 0 ? _nodes[_buckets[_current]].event.get() : _heap.top().get();
+}
+
+
+inline Voronoi::VertexEventPointer Voronoi::VertexEventQueue::create(const Point & site)
+{
+	++_statistics.Created;
+	if (_freeEvents.empty()) {
+		return allocateUnique<VertexEvent>(_resource, site);
+	}
+	auto event = std::move(_freeEvents.back());
+	_freeEvents.pop_back();
+	++_statistics.Recycled;
+	*event = VertexEvent(site);
+	return event;
+}
+
+
+inline void Voronoi::VertexEventQueue::release(VertexEventPointer event)
+{
+	_freeEvents.push_back(std::move(event));
+}
+
+
+inline const Voronoi::EventStatistics & Voronoi::VertexEventQueue::statistics() const
+{
+	return _statistics;
+}
+
+
+inline bool Voronoi::VertexEventQueue::isCalendar() const
+{
+	return _isCalendar;
+}
+
+
+#endif  // EVENTQUEUE_H
@@ -0,0 +1,220 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2015 Lukáš Bednařík l.bednarik@gmail.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef FIXEDVECTOR_H
+#define FIXEDVECTOR_H
+
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <cstddef>
+
+
+namespace Voronoi
+{
+	/// Vector with the capacity fixed at compile time and the storage inside the object
+	///
+	/// No heap allocation is ever made. Adding an element to a full vector throws `std::length_error`.
+	template <typename T, size_t N>
+	class FixedVector
+	{
+	public:
+		FixedVector();
+		FixedVector(const FixedVector & other);
+		FixedVector & operator=(const FixedVector & other);
+		~FixedVector();
+
+		size_t size() const;
+		bool empty() const;
+		static size_t capacity();
+		void clear();
+
+		void push_back(const T & value);
+
+		template <typename... Arguments>
+		void emplace_back(Arguments &&... arguments);
+
+		T & operator[](size_t index);
+		const T & operator[](size_t index) const;
+		T & back();
+		const T & back() const;
+
+		T * begin();
+		T * end();
+		const T * begin() const;
+		const T * end() const;
+
+	private:
+		typename std::aligned_storage<sizeof(T), alignof(T)>::type _storage[N];
+		size_t _size;
+	};
+}
+
+
+// Implementation
+
+template <typename T, size_t N>
+Voronoi::FixedVector<T, N>::FixedVector() :
+	_size(0)
+{
+}
+
+
+template <typename T, size_t N>
+Voronoi::FixedVector<T, N>::FixedVector(const FixedVector & other) :
+	_size(0)
+{
+	for (const auto & value : other) {
+		push_back(value);
+	}
+}
+
+
+template <typename T, size_t N>
+Voronoi::FixedVector<T, N> & Voronoi::FixedVector<T, N>::operator=(const FixedVector & other)
+{
+	if (this != &other) {
+		clear();
+		for (const auto & value : other) {
+			push_back(value);
+		}
+	}
+	return *this;
+}
+
+
+template <typename T, size_t N>
+Voronoi::FixedVector<T, N>::~FixedVector()
+{
+	clear();
+}
+
+
+template <typename T, size_t N>
+size_t Voronoi::FixedVector<T, N>::size() const
+{
+	return _size;
+}
+
+
+template <typename T, size_t N>
+bool Voronoi::FixedVector<T, N>::empty() const
+{
+	return _size == 0;
+}
+
+
+template <typename T, size_t N>
+size_t Voronoi::FixedVector<T, N>::capacity()
+{
+	return N;
+}
+
+
+template <typename T, size_t N>
+void Voronoi::FixedVector<T, N>::clear()
+{
+	for (auto & value : *this) {
+		value.~T();
+	}
+	_size = 0;
+}
+
+
+template <typename T, size_t N>
+void Voronoi::FixedVector<T, N>::push_back(const T & value)
+{
+	emplace_back(value);
+}
+
+
+template <typename T, size_t N>
+template <typename... Arguments>
+void Voronoi::FixedVector<T, N>::emplace_back(Arguments &&... arguments)
+{
+	if (_size == N) {
+		throw std::length_error("FixedVector is full!");
+	}
+	new (&_storage[_size]) T(std::forward<Arguments>(arguments)...);
+	++_size;
+}
+
+
+template <typename T, size_t N>
+T & Voronoi::FixedVector<T, N>::operator[](size_t index)
+{
+	return *reinterpret_cast<T *>(&_storage[index]);
+}
+
+
+template <typename T, size_t N>
+const T & Voronoi::FixedVector<T, N>::operator[](size_t index) const
+{
+	return *reinterpret_cast<const T *>(&_storage[index]);
+}
+
+
+template <typename T, size_t N>
+T & Voronoi::FixedVector<T, N>::back()
+{
+	return (*this)[_size - 1];
+}
+
+
+template <typename T, size_t N>
+const T & Voronoi::FixedVector<T, N>::back() const
+{
+	return (*this)[_size - 1];
+}
+
+
+template <typename T, size_t N>
+T * Voronoi::FixedVector<T, N>::begin()
+{
+	return reinterpret_cast<T *>(&_storage[0]);
+}
+
+
+template <typename T, size_t N>
+T * Voronoi::FixedVector<T, N>::end()
+{
+	return begin() + _size;
+}
+
+
+template <typename T, size_t N>
+const T * Voronoi::FixedVector<T, N>::begin() const
+{
+	return reinterpret_cast<const T *>(&_storage[0]);
+}
+
+
+template <typename T, size_t N>
+const T * Voronoi::FixedVector<T, N>::end() const
+{
+	return begin() + _size;
+}
+
+
+#endif  // FIXEDVECTOR_H
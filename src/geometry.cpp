@@ -3,6 +3,18 @@
 #include <algorithm>
 #include <cmath>
 #include <cassert>
+#include <limits>
+#include <vector>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define VORONOI_AVX
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VORONOI_SSE2
+#endif
 
 
 namespace
@@ -14,6 +26,283 @@ namespace
 	{
 		return angle < EpsilonRad && -angle < EpsilonRad;
 	}
+
+
+	/// Scalar fallback for the vectorized kernels
+	struct Scalar
+	{
+		typedef double Vector;
+		static const size_t Width = 1;
+		static Vector load(const double * p) { return *p; }
+		static void store(double * p, Vector v) { *p = v; }
+		static Vector set1(double v) { return v; }
+		static Vector add(Vector a, Vector b) { return a + b; }
+		static Vector sub(Vector a, Vector b) { return a - b; }
+		static Vector mul(Vector a, Vector b) { return a * b; }
+		static Vector div(Vector a, Vector b) { return a / b; }
+	};
+
+
+#ifdef VORONOI_SSE2
+	struct Sse2
+	{
+		typedef __m128d Vector;
+		static const size_t Width = 2;
+		static Vector load(const double * p) { return _mm_loadu_pd(p); }
+		static void store(double * p, Vector v) { _mm_storeu_pd(p, v); }
+		static Vector set1(double v) { return _mm_set1_pd(v); }
+		static Vector add(Vector a, Vector b) { return _mm_add_pd(a, b); }
+		static Vector sub(Vector a, Vector b) { return _mm_sub_pd(a, b); }
+		static Vector mul(Vector a, Vector b) { return _mm_mul_pd(a, b); }
+		static Vector div(Vector a, Vector b) { return _mm_div_pd(a, b); }
+	};
+#endif
+
+
+#ifdef VORONOI_AVX
+	struct Avx
+	{
+		typedef __m256d Vector;
+		static const size_t Width = 4;
+		static Vector load(const double * p) { return _mm256_loadu_pd(p); }
+		static void store(double * p, Vector v) { _mm256_storeu_pd(p, v); }
+		static Vector set1(double v) { return _mm256_set1_pd(v); }
+		static Vector add(Vector a, Vector b) { return _mm256_add_pd(a, b); }
+		static Vector sub(Vector a, Vector b) { return _mm256_sub_pd(a, b); }
+		static Vector mul(Vector a, Vector b) { return _mm256_mul_pd(a, b); }
+		static Vector div(Vector a, Vector b) { return _mm256_div_pd(a, b); }
+	};
+#endif
+
+
+	/// Coefficients of `Simd::Width` parabolas a * x * x + b * x + c given by their foci and a common directrix
+	template <typename Simd>
+	inline void parabolaCoefficients(const double * focusX, const double * focusY, double directrix,
+		double * a, double * b, double * c)
+	{
+		const typename Simd::Vector x = Simd::load(focusX);
+		const typename Simd::Vector y = Simd::set1(directrix);
+		const typename Simd::Vector dp = Simd::mul(Simd::set1(2.0), Simd::sub(Simd::load(focusY), y));
+		Simd::store(a, Simd::div(Simd::set1(1.0), dp));
+		Simd::store(b, Simd::div(Simd::mul(Simd::set1(-2.0), x), dp));
+		Simd::store(c, Simd::add(Simd::add(y, Simd::div(dp, Simd::set1(4.0))), Simd::div(Simd::mul(x, x), dp)));
+	}
+
+
+	/// Return "x" of two parabola intersection given the coefficients of their difference
+	inline double intersectionRoot(double a, double b, double c, bool isLeftLower)
+	{
+		// Degenerate case when foci of parabolas have the same `y` coordinate.
+		if (isZeroAngle(a)) {
+			return -c / b;
+		}
+
+		// Solve a quadratic equation when the difference of two parabolas is zero.
+		// This is when the two parabolas intersects.
+		const double disc = b*b - 4 * a * c;
+		assert(disc >= 0);  // We suppose parabolas intersect
+		const double x1 = (-b + std::sqrt(disc)) / (2*a);
+		const double x2 = (-b - std::sqrt(disc)) / (2*a);
+
+		// Suppose the left parabola is on the left.
+		// Check if the line will go up or down and decide which value to return.
+		if (isLeftLower) {
+			return std::max(x1, x2);
+		}
+		else {
+			return std::min(x1, x2);
+		}
+	}
+
+
+	/// Process `count - count % Simd::Width` triples, return the number of processed triples
+	template <typename Simd>
+	size_t circumcentersKernel(const Voronoi::Point * a, const Voronoi::Point * b, const Voronoi::Point * c,
+		Voronoi::Point * centers, size_t count)
+	{
+		const size_t Width = Simd::Width;
+		typedef typename Simd::Vector Vector;
+		size_t i = 0;
+		for (; i + Width <= count; i += Width) {
+			double coordinates[6][Width];
+			for (size_t k = 0; k < Width; ++k) {
+				coordinates[0][k] = a[i + k].x();
+				coordinates[1][k] = a[i + k].y();
+				coordinates[2][k] = b[i + k].x();
+				coordinates[3][k] = b[i + k].y();
+				coordinates[4][k] = c[i + k].x();
+				coordinates[5][k] = c[i + k].y();
+			}
+			const Vector ax = Simd::load(coordinates[0]);
+			const Vector ay = Simd::load(coordinates[1]);
+			const Vector bx = Simd::load(coordinates[2]);
+			const Vector by = Simd::load(coordinates[3]);
+			const Vector cx = Simd::load(coordinates[4]);
+			const Vector cy = Simd::load(coordinates[5]);
+
+			// The same symmetric formula as in `circumcenter`
+			const Vector na = Simd::add(Simd::mul(ax, ax), Simd::mul(ay, ay));
+			const Vector nb = Simd::add(Simd::mul(bx, bx), Simd::mul(by, by));
+			const Vector nc = Simd::add(Simd::mul(cx, cx), Simd::mul(cy, cy));
+			const Vector bc = Simd::sub(by, cy);
+			const Vector ca = Simd::sub(cy, ay);
+			const Vector ab = Simd::sub(ay, by);
+			const Vector x = Simd::add(Simd::add(Simd::mul(na, bc), Simd::mul(nb, ca)), Simd::mul(nc, ab));
+			const Vector y = Simd::add(Simd::add(Simd::mul(na, Simd::sub(cx, bx)), Simd::mul(nb, Simd::sub(ax, cx))),
+				Simd::mul(nc, Simd::sub(bx, ax)));
+			const Vector d = Simd::mul(Simd::set1(2.0),
+				Simd::add(Simd::add(Simd::mul(ax, bc), Simd::mul(bx, ca)), Simd::mul(cx, ab)));
+
+			double centerX[Width];
+			double centerY[Width];
+			double divisor[Width];
+			Simd::store(centerX, Simd::div(x, d));
+			Simd::store(centerY, Simd::div(y, d));
+			Simd::store(divisor, d);
+			for (size_t k = 0; k < Width; ++k) {
+				centers[i + k] = isZeroAngle(divisor[k]) ? Voronoi::Point() : Voronoi::Point(centerX[k], centerY[k]);
+			}
+		}
+		return i;
+	}
+
+
+	/// Process `count - count % Simd::Width` parabola pairs, return the number of processed pairs
+	template <typename Simd>
+	size_t parabolaIntersectionsKernel(const Voronoi::Point * leftParabolas, const Voronoi::Point * rightParabolas,
+		double directrix, double * x, size_t count)
+	{
+		const size_t Width = Simd::Width;
+		size_t i = 0;
+		for (; i + Width <= count; i += Width) {
+			double leftX[Width], leftY[Width], rightX[Width], rightY[Width];
+			for (size_t k = 0; k < Width; ++k) {
+				leftX[k] = leftParabolas[i + k].x();
+				leftY[k] = leftParabolas[i + k].y();
+				rightX[k] = rightParabolas[i + k].x();
+				rightY[k] = rightParabolas[i + k].y();
+			}
+			double a1[Width], b1[Width], c1[Width], a2[Width], b2[Width], c2[Width];
+			parabolaCoefficients<Simd>(leftX, leftY, directrix, a1, b1, c1);
+			parabolaCoefficients<Simd>(rightX, rightY, directrix, a2, b2, c2);
+			for (size_t k = 0; k < Width; ++k) {
+				x[i + k] = intersectionRoot(a1[k] - a2[k], b1[k] - b2[k], c1[k] - c2[k], leftY[k] < rightY[k]);
+			}
+		}
+		return i;
+	}
+
+
+	/// Bound of the relative rounding error of one floating point operation
+	const double RoundOff = std::numeric_limits<double>::epsilon() / 2;
+
+	/// Relative error bounds of the floating point `orientation` and `inCircle`, see Shewchuk's robust predicates
+	const double OrientationErrorBound = (3.0 + 16.0 * RoundOff) * RoundOff;
+	const double InCircleErrorBound = (10.0 + 96.0 * RoundOff) * RoundOff;
+
+
+	/// Exact sum `x + y` of two doubles where `x` is the rounded sum
+	inline void twoSum(double a, double b, double & x, double & y)
+	{
+		x = a + b;
+		const double bVirtual = x - a;
+		const double aVirtual = x - bVirtual;
+		y = (a - aVirtual) + (b - bVirtual);
+	}
+
+
+	/// Exact product `x + y` of two doubles where `x` is the rounded product
+	inline void twoProduct(double a, double b, double & x, double & y)
+	{
+		x = a * b;
+		y = std::fma(a, b, -x);
+	}
+
+
+	/// Exact value represented as a sum of non-overlapping doubles of increasing magnitude
+	///
+	/// Used by the predicates only when the floating point result is within its rounding error.
+	class Expansion
+	{
+	public:
+		explicit Expansion(double value)
+		{
+			if (value != 0.0) _terms.push_back(value);
+		}
+
+		/// Exact difference `a - b`
+		static Expansion difference(double a, double b)
+		{
+			double x, y;
+			twoSum(a, -b, x, y);
+			Expansion result(y);
+			if (x != 0.0) result._terms.push_back(x);
+			return result;
+		}
+
+		Expansion operator+(const Expansion & other) const
+		{
+			// Merge by magnitude and accumulate, see Fast-Expansion-Sum of Shewchuk
+			std::vector<double> merged(_terms.size() + other._terms.size());
+			std::merge(_terms.begin(), _terms.end(), other._terms.begin(), other._terms.end(), merged.begin(),
+				[] (double a, double b) { return std::abs(a) < std::abs(b); });
+			Expansion result(0.0);
+			if (merged.empty()) return result;
+			double sum = merged[0];
+			for (size_t i = 1; i < merged.size(); ++i) {
+				double error;
+				twoSum(sum, merged[i], sum, error);
+				if (error != 0.0) result._terms.push_back(error);
+			}
+			if (sum != 0.0) result._terms.push_back(sum);
+			return result;
+		}
+
+		Expansion operator-(const Expansion & other) const
+		{
+			Expansion negative(other);
+			for (double & term : negative._terms) term = -term;
+			return *this + negative;
+		}
+
+		Expansion operator*(const Expansion & other) const
+		{
+			Expansion result(0.0);
+			for (double factor : other._terms) {
+				result = result + _scale(factor);
+			}
+			return result;
+		}
+
+		/// Approximation of the value with the exact sign
+		double estimate() const
+		{
+			return _terms.empty() ? 0.0 : _terms.back();
+		}
+
+	private:
+		std::vector<double> _terms;
+
+		/// Exact product with a double, see Scale-Expansion of Shewchuk
+		Expansion _scale(double factor) const
+		{
+			Expansion result(0.0);
+			if (_terms.empty()) return result;
+			double sum, error;
+			twoProduct(_terms[0], factor, sum, error);
+			if (error != 0.0) result._terms.push_back(error);
+			for (size_t i = 1; i < _terms.size(); ++i) {
+				double product, productError, partial;
+				twoProduct(_terms[i], factor, product, productError);
+				twoSum(sum, productError, partial, error);
+				if (error != 0.0) result._terms.push_back(error);
+				twoSum(product, partial, sum, error);
+				if (error != 0.0) result._terms.push_back(error);
+			}
+			if (sum != 0.0) result._terms.push_back(sum);
+			return result;
+		}
+	};
 }
 
 
@@ -56,6 +345,99 @@ Voronoi::Point Voronoi::edgeIntersection(const Edge & left, const Edge & right)
 }
 
 
+bool Voronoi::clipEdge(Edge & edge, const BoundingBox & boundingBox)
+{
+	const Point begin = edge.begin();
+	const Point end = edge.end();
+	if (begin.isNull() || end.isNull()) {
+		return !begin.isNull() && begin.x() >= boundingBox.MinX && begin.x() <= boundingBox.MaxX &&
+			begin.y() >= boundingBox.MinY && begin.y() <= boundingBox.MaxY;
+	}
+
+	// Liang-Barsky: the edge is begin + t * (end - begin) for t in [t0, t1]
+	const double dx = end.x() - begin.x();
+	const double dy = end.y() - begin.y();
+	const double p[4] = { -dx, dx, -dy, dy };
+	const double q[4] = { begin.x() - boundingBox.MinX, boundingBox.MaxX - begin.x(),
+		begin.y() - boundingBox.MinY, boundingBox.MaxY - begin.y() };
+	double t0 = 0.0;
+	double t1 = 1.0;
+	for (int i = 0; i < 4; ++i) {
+		if (p[i] == 0.0) {
+			if (q[i] < 0.0) {
+				return false;  // Parallel to the box side and outside
+			}
+		}
+		else if (p[i] < 0.0) {
+			t0 = std::max(t0, q[i] / p[i]);
+		}
+		else {
+			t1 = std::min(t1, q[i] / p[i]);
+		}
+	}
+	if (t0 > t1) {
+		return false;
+	}
+	if (t0 > 0.0) {
+		edge.setBegin(Point(begin.x() + t0 * dx, begin.y() + t0 * dy));
+	}
+	if (t1 < 1.0) {
+		edge.setEnd(Point(begin.x() + t1 * dx, begin.y() + t1 * dy));
+	}
+	return true;
+}
+
+
+double Voronoi::orientation(const Point & a, const Point & b, const Point & c)
+{
+	const double left = (b.x() - a.x()) * (c.y() - b.y());
+	const double right = (b.y() - a.y()) * (c.x() - b.x());
+	const double determinant = left - right;
+	if (std::abs(determinant) > OrientationErrorBound * (std::abs(left) + std::abs(right))) {
+		return determinant;
+	}
+
+	// The sign may be wrong, evaluate it exactly
+	const Expansion exact = Expansion::difference(b.x(), a.x()) * Expansion::difference(c.y(), b.y()) -
+		Expansion::difference(b.y(), a.y()) * Expansion::difference(c.x(), b.x());
+	return exact.estimate();
+}
+
+
+double Voronoi::inCircle(const Point & a, const Point & b, const Point & c, const Point & d)
+{
+	const double adx = a.x() - d.x();
+	const double ady = a.y() - d.y();
+	const double bdx = b.x() - d.x();
+	const double bdy = b.y() - d.y();
+	const double cdx = c.x() - d.x();
+	const double cdy = c.y() - d.y();
+	const double aLift = adx * adx + ady * ady;
+	const double bLift = bdx * bdx + bdy * bdy;
+	const double cLift = cdx * cdx + cdy * cdy;
+	const double determinant = aLift * (bdx * cdy - cdx * bdy) + bLift * (cdx * ady - adx * cdy) +
+		cLift * (adx * bdy - bdx * ady);
+	const double permanent = aLift * (std::abs(bdx * cdy) + std::abs(cdx * bdy)) +
+		bLift * (std::abs(cdx * ady) + std::abs(adx * cdy)) + cLift * (std::abs(adx * bdy) + std::abs(bdx * ady));
+	if (std::abs(determinant) > InCircleErrorBound * permanent) {
+		return determinant;
+	}
+
+	// Cocircular or nearly cocircular points, evaluate the sign exactly
+	const Expansion adxExact = Expansion::difference(a.x(), d.x());
+	const Expansion adyExact = Expansion::difference(a.y(), d.y());
+	const Expansion bdxExact = Expansion::difference(b.x(), d.x());
+	const Expansion bdyExact = Expansion::difference(b.y(), d.y());
+	const Expansion cdxExact = Expansion::difference(c.x(), d.x());
+	const Expansion cdyExact = Expansion::difference(c.y(), d.y());
+	const Expansion exact =
+		(adxExact * adxExact + adyExact * adyExact) * (bdxExact * cdyExact - cdxExact * bdyExact) +
+		(bdxExact * bdxExact + bdyExact * bdyExact) * (cdxExact * adyExact - adxExact * cdyExact) +
+		(cdxExact * cdxExact + cdyExact * cdyExact) * (adxExact * bdyExact - bdxExact * adyExact);
+	return exact.estimate();
+}
+
+
 Voronoi::Point Voronoi::circumcenter(const Point & a, const Point & b, const Point & c)
 {
 	// This equation can be expressed in a simplified form after translation of the vertex A to the origin
@@ -74,6 +456,19 @@ Voronoi::Point Voronoi::circumcenter(const Point & a, const Point & b, const Poi
 }
 
 
+void Voronoi::circumcenters(const Point * a, const Point * b, const Point * c, Point * centers, size_t count)
+{
+	size_t done = 0;
+#ifdef VORONOI_AVX
+	done += circumcentersKernel<Avx>(a, b, c, centers, count);
+#endif
+#ifdef VORONOI_SSE2
+	done += circumcentersKernel<Sse2>(a + done, b + done, c + done, centers + done, count - done);
+#endif
+	circumcentersKernel<Scalar>(a + done, b + done, c + done, centers + done, count - done);
+}
+
+
 double Voronoi::circumcircleRadius(const Point & a, const Point & b, const Point & c)
 {
 	auto norm = [] (const Point & p) -> double { return std::sqrt(p.x() * p.x() + p.y() * p.y()); };
@@ -115,45 +510,34 @@ double Voronoi::parabolaIntersectionX(const Point & leftParabola, const Point &
 	assert(!isZeroAngle(r.y() - y));  // We suppose parabola is not degenerate
 	assert(!isZeroAngle(p.y() - y));  // We suppose parabola is not degenerate
 
-	// Coefficients of the first parabola
-	// a1 * x * x + b1 * x + c1 = 0
-	const double dp1 = 2.0 * (p.y() - y);
-	const double a1 = 1.0 / dp1;
-	const double b1 = -2.0 * p.x() / dp1;
-	const double c1 = y + dp1 / 4 + p.x() * p.x() / dp1;
-
-	// Coefficients of the second parabola
-	// a2 * x * x + b2 * x + c2 = 0
-	const double dp2 = 2.0 * (r.y() - y);
-	const double a2 = 1.0 / dp2;
-	const double b2 = -2.0 * r.x() / dp2;
-	const double c2 = y + dp2 / 4 + r.x() * r.x() / dp2;
+	// Coefficients of both parabolas at once, the first parabola is at index 0
+	// a * x * x + b * x + c = 0
+	const double focusX[2] = { p.x(), r.x() };
+	const double focusY[2] = { p.y(), r.y() };
+	double a[2], b[2], c[2];
+#ifdef VORONOI_SSE2
+	parabolaCoefficients<Sse2>(focusX, focusY, y, a, b, c);
+#else
+	parabolaCoefficients<Scalar>(focusX, focusY, y, a, b, c);
+	parabolaCoefficients<Scalar>(focusX + 1, focusY + 1, y, a + 1, b + 1, c + 1);
+#endif
 
 	// Coefficients for difference of two parabolas
-	const double a = a1 - a2;
-	const double b = b1 - b2;
-	const double c = c1 - c2;
-
-	// Degenerate case when foci of parabolas have the same `y` coordinate.
-	if (isZeroAngle(a)) {
-		return -c / b;
-	}
+	return intersectionRoot(a[0] - a[1], b[0] - b[1], c[0] - c[1], p.y() < r.y());
+}
 
-	// Solve a quadratic equation when the difference of two parabolas is zero.
-	// This is when the two parabolas intersects.
-	const double disc = b*b - 4 * a * c;
-	assert(disc >= 0);  // We suppose parabolas intersect
-	const double x1 = (-b + std::sqrt(disc)) / (2*a);
-	const double x2 = (-b - std::sqrt(disc)) / (2*a);
 
-	// Suppose parabola "p" is on the left.
-	// Check if the line will go up or down and decide which value to return.
-	if (p.y() < r.y()) {
-		return std::max(x1, x2);
-	}
-	else {
-		return std::min(x1, x2);
-	}	
+void Voronoi::parabolaIntersectionsX(const Point * leftParabolas, const Point * rightParabolas, double directrix,
+	double * x, size_t count)
+{
+	size_t done = 0;
+#ifdef VORONOI_AVX
+	done += parabolaIntersectionsKernel<Avx>(leftParabolas, rightParabolas, directrix, x, count);
+#endif
+#ifdef VORONOI_SSE2
+	done += parabolaIntersectionsKernel<Sse2>(leftParabolas + done, rightParabolas + done, directrix, x + done, count - done);
+#endif
+	parabolaIntersectionsKernel<Scalar>(leftParabolas + done, rightParabolas + done, directrix, x + done, count - done);
 }
 
 
@@ -26,7 +26,9 @@
 
 #include "point.h"
 #include "edge.h"
+#include "boundingbox.h"
 #include <memory>
+#include <cstddef>
 
 
 namespace Voronoi
@@ -36,11 +38,33 @@ namespace Voronoi
 	/// Return null point if no intersection exists.
 	Point edgeIntersection(const Edge & left, const Edge & right);
 
+	/// Clip the edge to the bounding box
+	///
+	/// An edge with no end is kept as it is if its beginning lies in the box.
+	/// @return false if no part of the edge lies in the box.
+	bool clipEdge(Edge & edge, const BoundingBox & boundingBox);
+
+	/// Twice the signed area of triangle [a, b, c]
+	///
+	/// Positive if the points turn counter-clockwise, negative if clockwise, zero if collinear.
+	/// The sign is exact, nearly collinear points are evaluated in exact arithmetic.
+	double orientation(const Point & a, const Point & b, const Point & c);
+
+	/// Positive if `d` lies inside the circumcircle of counter-clockwise triangle [a, b, c]
+	///
+	/// Zero if the points are cocircular. The sign is exact as in `orientation`.
+	double inCircle(const Point & a, const Point & b, const Point & c, const Point & d);
+
 	/// Circumcenter of three points
 	///
 	/// @return null point if no circumcenter exists.
 	Point circumcenter(const Point & a, const Point & b, const Point & c);
 
+	/// Circumcenters of `count` triples [a[i], b[i], c[i]]
+	///
+	/// Vectorized version of `circumcenter` using AVX or SSE2 when available.
+	void circumcenters(const Point * a, const Point * b, const Point * c, Point * centers, size_t count);
+
 	/// Circumcircle radius of three points
 	double circumcircleRadius(const Point & a, const Point & b, const Point & c);
 
@@ -59,6 +83,10 @@ namespace Voronoi
 	/// @param y Directrix of parabolas.
 	/// @return x coordinate of parabola intersection.
 	double parabolaIntersectionX(const Point & leftParabola, const Point & rightParabola, double directrix);
+
+	/// Vectorized version of `parabolaIntersectionX` for `count` pairs of parabolas with a common directrix
+	void parabolaIntersectionsX(const Point * leftParabolas, const Point * rightParabolas, double directrix,
+		double * x, size_t count);
 }
 
 
@@ -0,0 +1,179 @@
+#include "interpolation.h"
+#include "geometry.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+
+namespace
+{
+	const uint32_t NoTriangle = 0xffffffff;
+
+	const uint32_t Next[3] = { 1, 2, 0 };
+	const uint32_t Previous[3] = { 2, 0, 1 };
+
+
+	double cross(const Voronoi::Point & a, const Voronoi::Point & b)
+	{
+		return a.x() * b.y() - a.y() * b.x();
+	}
+}  // end of anonymous namespace
+
+
+Voronoi::NaturalNeighbourInterpolator::NaturalNeighbourInterpolator(const Triangulation & triangulation,
+	std::vector<double> values) :
+	_triangulation(triangulation),
+	_values(std::move(values))
+{
+	if (_values.size() != triangulation.getSites().size()) {
+		throw std::invalid_argument("NaturalNeighbourInterpolator: There must be one value per site!");
+	}
+}
+
+
+double Voronoi::NaturalNeighbourInterpolator::interpolate(const Point & point) const
+{
+	Workspace workspace;
+	workspace.Start = _triangulation._last;
+	return _interpolate(point, workspace);
+}
+
+
+void Voronoi::NaturalNeighbourInterpolator::interpolate(const Point * points, size_t count, double * results,
+	ThreadPool * pool) const
+{
+	auto interpolateRange = [this, points, results](size_t begin, size_t end) {
+		Workspace workspace;
+		workspace.Start = _triangulation._last;
+		for (size_t i = begin; i < end; ++i) {
+			results[i] = _interpolate(points[i], workspace);
+		}
+	};
+	if (pool) {
+		pool->parallelFor(count, interpolateRange);
+	}
+	else {
+		interpolateRange(0, count);
+	}
+}
+
+
+std::vector<std::pair<uint32_t, double>> Voronoi::NaturalNeighbourInterpolator::coordinates(const Point & point) const
+{
+	Workspace workspace;
+	workspace.Start = _triangulation._last;
+	if (!_coordinates(point, workspace)) {
+		return std::vector<std::pair<uint32_t, double>>();
+	}
+	return workspace.Neighbours;
+}
+
+
+double Voronoi::NaturalNeighbourInterpolator::_interpolate(const Point & point, Workspace & workspace) const
+{
+	if (!_coordinates(point, workspace)) {
+		return std::numeric_limits<double>::quiet_NaN();
+	}
+	double value = 0.0;
+	for (const auto & neighbour : workspace.Neighbours) {
+		value += neighbour.second * _values[neighbour.first];
+	}
+	return value;
+}
+
+
+bool Voronoi::NaturalNeighbourInterpolator::_coordinates(const Point & point, Workspace & workspace) const
+{
+	const auto & points = _triangulation._points;
+	const auto & triangles = _triangulation._triangles;
+	auto & cavity = workspace.Cavity;
+	auto & neighbours = workspace.Neighbours;
+	neighbours.clear();
+
+	const uint32_t start = _triangulation._locate(point, workspace.Start);
+	workspace.Start = start;
+	for (uint32_t vertex : triangles[start].vertices) {
+		if (points[vertex] == point) {
+			if (!_triangulation._isSite(vertex)) {
+				return false;
+			}
+			neighbours.emplace_back(vertex, 1.0);
+			return true;
+		}
+	}
+
+	// The triangles whose circumcircles contain the point, a vertex of the super triangle means
+	// the point lies outside of the hull
+	cavity.assign(1, start);
+	auto isInCavity = [&cavity](uint32_t triangle) {
+		return std::find(cavity.begin(), cavity.end(), triangle) != cavity.end();
+	};
+	for (size_t i = 0; i < cavity.size(); ++i) {
+		for (uint32_t vertex : triangles[cavity[i]].vertices) {
+			if (!_triangulation._isSite(vertex)) {
+				return false;
+			}
+		}
+		for (uint32_t neighbour : triangles[cavity[i]].neighbours) {
+			if (neighbour == NoTriangle || isInCavity(neighbour)) {
+				continue;
+			}
+			const auto & vertices = triangles[neighbour].vertices;
+			if (inCircle(points[vertices[0]], points[vertices[1]], points[vertices[2]], point) > 0.0) {
+				cavity.push_back(neighbour);
+			}
+		}
+	}
+
+	// The part of the new cell taken from a site is bounded by the old edges of the site, which run
+	// through the circumcenters of the cavity triangles, and by the bisector of the site and the point.
+	// Its area is summed per triangle with the origin on that bisector, so the bisector adds nothing.
+	for (uint32_t triangle : cavity) {
+		const auto & vertices = triangles[triangle].vertices;
+		const Point center = circumcenter(points[vertices[0]], points[vertices[1]], points[vertices[2]]);
+
+		// A cavity edge is cut by the new cell at the circumcenter with the point. Within the cavity any
+		// point of the bisector of the edge does, the pieces of the two triangles add up to the old edge.
+		Point edgePoints[3];
+		for (int k = 0; k < 3; ++k) {
+			const Point & begin = points[vertices[Next[k]]];
+			const Point & end = points[vertices[Previous[k]]];
+			const uint32_t neighbour = triangles[triangle].neighbours[k];
+			const bool isInside = neighbour != NoTriangle && isInCavity(neighbour);
+			edgePoints[k] = isInside ? (begin + end) / 2.0 : circumcenter(point, begin, end);
+			if (edgePoints[k].isNull()) {
+				return false;
+			}
+		}
+
+		// Twice the signed areas, the sign is the same for all the triangles of a site
+		for (int i = 0; i < 3; ++i) {
+			const Point origin = (point + points[vertices[i]]) / 2.0;
+			const double area = cross(edgePoints[Next[i]] - origin, center - origin) +
+				cross(center - origin, edgePoints[Previous[i]] - origin);
+			auto neighbour = std::find_if(neighbours.begin(), neighbours.end(), [&vertices, i](const std::pair<uint32_t, double> & item) {
+				return item.first == vertices[i];
+			});
+			if (neighbour == neighbours.end()) {
+				neighbours.emplace_back(vertices[i], area);
+			}
+			else {
+				neighbour->second += area;
+			}
+		}
+	}
+
+	double total = 0.0;
+	for (auto & neighbour : neighbours) {
+		neighbour.second = std::fabs(neighbour.second);
+		total += neighbour.second;
+	}
+	if (!(total > 0.0)) {
+		return false;
+	}
+	for (auto & neighbour : neighbours) {
+		neighbour.second /= total;
+	}
+	return true;
+}
@@ -0,0 +1,87 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2015 Lukáš Bednařík l.bednarik@gmail.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+#ifndef INTERPOLATION_H
+#define INTERPOLATION_H
+
+#include "delaunay.h"
+#include "threadpool.h"
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+
+
+namespace Voronoi
+{
+	/// Natural neighbour (Sibson) interpolation of the values at the sites of a triangulation
+	///
+	/// A query point is located by a walk in the triangulation. The triangles whose circumcircles
+	/// contain it form the cavity it would open if inserted; the vertices of the cavity are its natural
+	/// neighbours. The weight of a neighbour is the area the cell of the point would take from the
+	/// neighbour's cell, summed triangle by triangle from the circumcenters. The triangulation isn't
+	/// changed, so the queries can run in parallel.
+	///
+	/// Points outside of the convex hull of the sites have no natural neighbours and give NaN,
+	/// as do points within rounding error of the hull.
+	class NaturalNeighbourInterpolator
+	{
+	public:
+		/// `values[site]` is the value at the site, the triangulation must outlive the interpolator
+		NaturalNeighbourInterpolator(const Triangulation & triangulation, std::vector<double> values);
+
+		double interpolate(const Point & point) const;
+
+		/// Interpolate `count` points into `results`, chunks of the points run in the pool
+		///
+		/// The walk of a point starts where the previous point of the chunk was found, so the rows
+		/// of a grid cost little more than the area calculation.
+		void interpolate(const Point * points, size_t count, double * results, ThreadPool * pool = nullptr) const;
+
+		/// Natural neighbours of the point with their Sibson coordinates, which sum up to one
+		///
+		/// Empty outside of the convex hull.
+		std::vector<std::pair<uint32_t, double>> coordinates(const Point & point) const;
+
+	private:
+		/// Buffers of one thread, reused by its queries
+		struct Workspace
+		{
+			std::vector<uint32_t> Cavity;
+			std::vector<std::pair<uint32_t, double>> Neighbours;
+			uint32_t Start;  ///< Triangle of the previous point
+		};
+
+		const Triangulation & _triangulation;
+		std::vector<double> _values;
+
+		double _interpolate(const Point & point, Workspace & workspace) const;
+
+		/// Fill the neighbours of the workspace, false outside of the hull
+		bool _coordinates(const Point & point, Workspace & workspace) const;
+	};
+}
+
+
+#endif  // INTERPOLATION_H
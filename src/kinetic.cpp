@@ -0,0 +1,435 @@
+#include "kinetic.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+
+namespace
+{
+	const uint32_t NoTriangle = 0xffffffff;
+
+	const uint32_t Next[3] = { 1, 2, 0 };
+	const uint32_t Previous[3] = { 2, 0, 1 };
+
+	/// Leading coefficients smaller than this fraction of the largest one are dropped
+	const double CoefficientEpsilon = 1e-14;
+
+	/// Coefficients of the in-circle polynomial within this fraction of the sum of the absolute values
+	/// of their terms are rounding errors, they are zero for sites which stay cocircular
+	const double CoefficientErrorBound = 64.0 * std::numeric_limits<double>::epsilon();
+
+	/// Relative precision of the failure times
+	const double RootTolerance = 1e-13;
+
+	const int MaxRootSteps = 200;
+
+	/// Roots this little before the current time are still taken, the ones of edges which
+	/// failed within the rounding error of the previous flips
+	const double TimeEpsilon = 1e-9;
+
+
+	/// Polynomial c[0] + c[1] * t + ... + c[degree] * t^degree
+	struct Polynomial
+	{
+		double c[5];
+		int degree;
+	};
+
+
+	/// Coordinates of the point `a - b` as polynomials of time
+	void difference(const Voronoi::Point & originA, const Voronoi::Point & velocityA,
+		const Voronoi::Point & originB, const Voronoi::Point & velocityB, Polynomial & x, Polynomial & y)
+	{
+		x.c[0] = originA.x() - originB.x();
+		x.c[1] = velocityA.x() - velocityB.x();
+		x.degree = 1;
+		y.c[0] = originA.y() - originB.y();
+		y.c[1] = velocityA.y() - velocityB.y();
+		y.degree = 1;
+	}
+
+
+	Polynomial multiply(const Polynomial & left, const Polynomial & right)
+	{
+		Polynomial product;
+		product.degree = left.degree + right.degree;
+		std::fill(product.c, product.c + 5, 0.0);
+		for (int i = 0; i <= left.degree; ++i) {
+			for (int j = 0; j <= right.degree; ++j) {
+				product.c[i + j] += left.c[i] * right.c[j];
+			}
+		}
+		return product;
+	}
+
+
+	/// Return `left + sign * right`
+	Polynomial add(const Polynomial & left, const Polynomial & right, double sign = 1.0)
+	{
+		Polynomial sum;
+		sum.degree = std::max(left.degree, right.degree);
+		for (int i = 0; i <= sum.degree; ++i) {
+			sum.c[i] = (i <= left.degree ? left.c[i] : 0.0) + sign * (i <= right.degree ? right.c[i] : 0.0);
+		}
+		return sum;
+	}
+
+
+	/// Polynomial with the absolute values of the coefficients
+	Polynomial absolute(const Polynomial & polynomial)
+	{
+		Polynomial result = polynomial;
+		for (int i = 0; i <= result.degree; ++i) {
+			result.c[i] = std::fabs(result.c[i]);
+		}
+		return result;
+	}
+
+
+	/// In-circle test of the origin in the triangle with the vertices `(x[k], y[k])`, see `inCircle`
+	///
+	/// With `sign` +1 and the absolute values of the coordinates it's the bound of the terms.
+	Polynomial inCircle(const Polynomial * x, const Polynomial * y, double sign)
+	{
+		Polynomial test = { { 0.0 }, 0 };
+		for (int k = 0; k < 3; ++k) {
+			const int l = Next[k];
+			const int m = Previous[k];
+			const Polynomial length = add(multiply(x[k], x[k]), multiply(y[k], y[k]));
+			const Polynomial cross = add(multiply(x[l], y[m]), multiply(x[m], y[l]), sign);
+			test = add(test, multiply(length, cross));
+		}
+		return test;
+	}
+
+
+	double evaluate(const Polynomial & polynomial, double t)
+	{
+		double value = polynomial.c[polynomial.degree];
+		for (int i = polynomial.degree - 1; i >= 0; --i) {
+			value = value * t + polynomial.c[i];
+		}
+		return value;
+	}
+
+
+	/// Drop the negligible leading coefficients
+	void trim(Polynomial & polynomial)
+	{
+		double largest = 0.0;
+		for (int i = 0; i <= polynomial.degree; ++i) {
+			largest = std::max(largest, std::fabs(polynomial.c[i]));
+		}
+		while (polynomial.degree > 0 && std::fabs(polynomial.c[polynomial.degree]) <= CoefficientEpsilon * largest) {
+			--polynomial.degree;
+		}
+	}
+
+
+	/// Find the roots in (lower, upper] in the increasing order, return their count
+	///
+	/// The roots of the derivative split the interval into monotonic parts, each of them
+	/// holds one root at most. It's found by Newton's method, which falls back to bisection
+	/// when a step leaves the bracket.
+	int findRoots(const Polynomial & polynomial, double lower, double upper, double * roots)
+	{
+		if (polynomial.degree == 0) {
+			return 0;
+		}
+		if (polynomial.degree == 1) {
+			const double root = -polynomial.c[0] / polynomial.c[1];
+			roots[0] = root;
+			return (root > lower && root <= upper) ? 1 : 0;
+		}
+
+		Polynomial derivative;
+		derivative.degree = polynomial.degree - 1;
+		for (int i = 1; i <= polynomial.degree; ++i) {
+			derivative.c[i - 1] = i * polynomial.c[i];
+		}
+		double bounds[6];
+		bounds[0] = lower;
+		int boundCount = 1 + findRoots(derivative, lower, upper, bounds + 1);
+		bounds[boundCount++] = upper;
+
+		int count = 0;
+		for (int i = 0; i + 1 < boundCount; ++i) {
+			double left = bounds[i];
+			double right = bounds[i + 1];
+			const double leftValue = evaluate(polynomial, left);
+			const double rightValue = evaluate(polynomial, right);
+			if (rightValue == 0.0) {
+				if (right > lower && (count == 0 || roots[count - 1] != right)) {
+					roots[count++] = right;
+				}
+				continue;
+			}
+			if (leftValue == 0.0 || (leftValue < 0.0) == (rightValue < 0.0)) {
+				continue;
+			}
+			double root = 0.5 * (left + right);
+			for (int step = 0; step < MaxRootSteps; ++step) {
+				const double value = evaluate(polynomial, root);
+				if (value == 0.0) {
+					break;
+				}
+				if ((value < 0.0) == (leftValue < 0.0)) {
+					left = root;
+				}
+				else {
+					right = root;
+				}
+				const double slope = evaluate(derivative, root);
+				double next = (slope != 0.0) ? root - value / slope : left;
+				if (!(next > left && next < right)) {
+					next = 0.5 * (left + right);
+				}
+				const bool isPrecise = std::fabs(next - root) <= RootTolerance * std::max(1.0, std::fabs(next));
+				root = next;
+				if (isPrecise) {
+					break;
+				}
+			}
+			roots[count++] = root;
+		}
+		return count;
+	}
+
+
+	/// First time after `now` when the polynomial turns positive, infinity if never
+	double failureTime(Polynomial polynomial, double now)
+	{
+		const double earliest = now - TimeEpsilon * std::max(1.0, std::fabs(now));
+		trim(polynomial);
+		if (polynomial.degree == 0) {
+			return HUGE_VAL;
+		}
+
+		// All roots lie within the Cauchy bound
+		double bound = 0.0;
+		for (int i = 0; i < polynomial.degree; ++i) {
+			bound = std::max(bound, std::fabs(polynomial.c[i] / polynomial.c[polynomial.degree]));
+		}
+		bound += 1.0;
+		if (earliest >= bound) {
+			return HUGE_VAL;
+		}
+
+		double roots[4];
+		const int count = findRoots(polynomial, earliest, bound, roots);
+		for (int i = 0; i < count; ++i) {
+			// Past the last root the sign is the sign of the leading coefficient
+			const bool isPositive = (i + 1 < count) ?
+				evaluate(polynomial, 0.5 * (roots[i] + roots[i + 1])) > 0.0 :
+				polynomial.c[polynomial.degree] > 0.0;
+			if (isPositive) {
+				return std::max(roots[i], now);
+			}
+		}
+		return HUGE_VAL;
+	}
+}  // end of anonymous namespace
+
+
+Voronoi::KineticDiagram::KineticDiagram(const std::vector<Point> & sites, const std::vector<Point> & velocities,
+	const BoundingBox & boundingBox) :
+	_triangulation(sites, boundingBox),
+	_origins(_triangulation._points),
+	_velocities(velocities),
+	_versions(_triangulation._triangles.size(), 0),
+	_pointTriangles(_triangulation._points.size(), NoTriangle),
+	_time(0.0),
+	_flipCount(0)
+{
+	if (velocities.size() != sites.size()) {
+		throw std::invalid_argument("KineticDiagram: One velocity per site is required!");
+	}
+
+	// The vertices of the super triangle stay where they are
+	_velocities.resize(_origins.size(), Point(0.0, 0.0));
+	_isMoving.resize(sites.size(), false);
+	for (uint32_t i = 0; i < sites.size(); ++i) {
+		if (velocities[i] != Point(0.0, 0.0)) {
+			_movingSites.push_back(i);
+			_isMoving[i] = true;
+		}
+	}
+
+	const auto & triangles = _triangulation._triangles;
+	for (uint32_t i = 0; i < triangles.size(); ++i) {
+		if (_triangulation._isAlive(i)) {
+			for (uint32_t vertex : triangles[i].vertices) {
+				_pointTriangles[vertex] = i;
+			}
+		}
+	}
+	_scheduleAll();
+}
+
+
+void Voronoi::KineticDiagram::advance(double duration)
+{
+	const double end = _time + duration;
+	while (!_certificates.empty() && _certificates.top().time <= end) {
+		const Certificate certificate = _certificates.top();
+		_certificates.pop();
+		const uint32_t neighbour = _triangulation._triangles[certificate.triangle].neighbours[certificate.edge];
+		if (neighbour != certificate.neighbour || _versions[certificate.triangle] != certificate.version ||
+			_versions[neighbour] != certificate.neighbourVersion) {
+			continue;  // stale
+		}
+		_time = certificate.time;
+		_flip(certificate.triangle, certificate.edge);
+	}
+	_time = end;
+	_updatePositions();
+
+	// The stale certificates far in the future pile up
+	if (_certificates.size() > 4 * _triangulation._triangles.size()) {
+		_scheduleAll();
+	}
+}
+
+
+void Voronoi::KineticDiagram::setVelocity(uint32_t site, const Point & velocity)
+{
+	// The site continues from its current position
+	_origins[site] = _origins[site] + _velocities[site] * _time - velocity * _time;
+	_velocities[site] = velocity;
+	if (!_isMoving[site]) {
+		_movingSites.push_back(site);
+		_isMoving[site] = true;
+	}
+
+	const uint32_t start = _pointTriangles[site];
+	if (start == NoTriangle) {
+		return;  // not in the triangulation
+	}
+
+	// Walk around the site, every edge of its triangles has a new certificate
+	const auto & triangles = _triangulation._triangles;
+	std::vector<uint32_t> around;
+	uint32_t triangle = start;
+	do {
+		around.push_back(triangle);
+		++_versions[triangle];
+		const auto & vertices = triangles[triangle].vertices;
+		const uint32_t i = static_cast<uint32_t>(std::find(vertices, vertices + 3, site) - vertices);
+		triangle = triangles[triangle].neighbours[Previous[i]];
+	} while (triangle != start && triangle != NoTriangle);
+	for (uint32_t t : around) {
+		for (uint32_t edge = 0; edge < 3; ++edge) {
+			_schedule(t, edge);
+		}
+	}
+}
+
+
+void Voronoi::KineticDiagram::_scheduleAll()
+{
+	_certificates = std::priority_queue<Certificate, std::vector<Certificate>, LaterCertificate>();
+	const auto & triangles = _triangulation._triangles;
+	for (uint32_t i = 0; i < triangles.size(); ++i) {
+		if (!_triangulation._isAlive(i)) {
+			continue;
+		}
+		for (uint32_t edge = 0; edge < 3; ++edge) {
+			if (triangles[i].neighbours[edge] != NoTriangle && i < triangles[i].neighbours[edge]) {
+				_schedule(i, edge);
+			}
+		}
+	}
+}
+
+
+void Voronoi::KineticDiagram::_schedule(uint32_t triangle, uint32_t edge)
+{
+	const auto & triangles = _triangulation._triangles;
+	const uint32_t neighbour = triangles[triangle].neighbours[edge];
+	if (neighbour == NoTriangle) {
+		return;
+	}
+	const auto & neighbours = triangles[neighbour].neighbours;
+	const uint32_t j = static_cast<uint32_t>(std::find(neighbours, neighbours + 3, triangle) - neighbours);
+	const uint32_t d = triangles[neighbour].vertices[j];
+
+	// In-circle test of the opposite vertex as a quartic polynomial of time
+	Polynomial x[3];
+	Polynomial y[3];
+	Polynomial xBound[3];
+	Polynomial yBound[3];
+	for (int k = 0; k < 3; ++k) {
+		const uint32_t vertex = triangles[triangle].vertices[k];
+		difference(_origins[vertex], _velocities[vertex], _origins[d], _velocities[d], x[k], y[k]);
+		xBound[k] = absolute(x[k]);
+		yBound[k] = absolute(y[k]);
+	}
+	Polynomial test = inCircle(x, y, -1.0);
+
+	// Without the rounding errors the sites of a grid would flip back and forth when they are cocircular
+	const Polynomial bound = inCircle(xBound, yBound, 1.0);
+	for (int i = 0; i <= test.degree; ++i) {
+		if (std::fabs(test.c[i]) <= CoefficientErrorBound * bound.c[i]) {
+			test.c[i] = 0.0;
+		}
+	}
+
+	const double time = failureTime(test, _time);
+	if (time != HUGE_VAL) {
+		_certificates.push(Certificate{ time, triangle, edge, neighbour, _versions[triangle], _versions[neighbour] });
+	}
+}
+
+
+void Voronoi::KineticDiagram::_flip(uint32_t t, uint32_t k)
+{
+	// Triangles [c, a, b] and [d, b, a] become [c, a, d] and [c, d, b]
+	auto & triangles = _triangulation._triangles;
+	const uint32_t n = triangles[t].neighbours[k];
+	const auto & neighbours = triangles[n].neighbours;
+	const uint32_t j = static_cast<uint32_t>(std::find(neighbours, neighbours + 3, t) - neighbours);
+
+	const uint32_t c = triangles[t].vertices[k];
+	const uint32_t a = triangles[t].vertices[Next[k]];
+	const uint32_t b = triangles[t].vertices[Previous[k]];
+	const uint32_t d = triangles[n].vertices[j];
+	const uint32_t outsideCA = triangles[t].neighbours[Previous[k]];
+	const uint32_t outsideBC = triangles[t].neighbours[Next[k]];
+	const uint32_t outsideAD = triangles[n].neighbours[Next[j]];
+	const uint32_t outsideDB = triangles[n].neighbours[Previous[j]];
+
+	triangles[t] = Triangulation::Triangle{ { c, a, d }, { outsideAD, n, outsideCA } };
+	triangles[n] = Triangulation::Triangle{ { c, d, b }, { outsideDB, outsideBC, t } };
+	if (outsideAD != NoTriangle) {
+		std::replace(triangles[outsideAD].neighbours, triangles[outsideAD].neighbours + 3, n, t);
+	}
+	if (outsideBC != NoTriangle) {
+		std::replace(triangles[outsideBC].neighbours, triangles[outsideBC].neighbours + 3, t, n);
+	}
+	_pointTriangles[a] = t;
+	_pointTriangles[b] = n;
+	_pointTriangles[c] = t;
+	_pointTriangles[d] = t;
+	++_versions[t];
+	++_versions[n];
+	++_flipCount;
+
+	// The new diagonal and the four sides of the quadrilateral
+	_schedule(t, 0);
+	_schedule(t, 1);
+	_schedule(t, 2);
+	_schedule(n, 0);
+	_schedule(n, 1);
+}
+
+
+void Voronoi::KineticDiagram::_updatePositions()
+{
+	auto & points = _triangulation._points;
+	auto & sites = _triangulation._sites;
+	for (uint32_t site : _movingSites) {
+		points[site] = _origins[site] + _velocities[site] * _time;
+		sites[site] = points[site];
+	}
+}
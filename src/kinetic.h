@@ -0,0 +1,163 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2015 Lukáš Bednařík l.bednarik@gmail.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+#ifndef KINETIC_H
+#define KINETIC_H
+
+#include "delaunay.h"
+#include <vector>
+#include <list>
+#include <queue>
+#include <cstdint>
+
+
+namespace Voronoi
+{
+	/// Delaunay triangulation and Voronoi diagram of sites moving along straight lines
+	///
+	/// Every edge of the triangulation has a certificate, the in-circle test of its two triangles.
+	/// The time when the test fails is a root of a quartic polynomial and the certificates wait in
+	/// a priority queue. `advance` moves the time forward and flips the edges whose certificates
+	/// fail on the way, so the cost of a tick is proportional to the number of topology changes
+	/// plus the number of moving sites, whose positions are updated. The certificates of sites
+	/// which stay cocircular, like the corners of a rectangle, never fail.
+	///
+	/// The sites must stay within the super triangle of the triangulation, i.e. a thousand times
+	/// the size of the box. The diagram is clipped to the box.
+	class KineticDiagram
+	{
+	public:
+		/// Sites outside of the box and duplicate sites are left out of the triangulation
+		KineticDiagram(const std::vector<Point> & sites, const std::vector<Point> & velocities,
+			const BoundingBox & boundingBox = BoundingBox());
+
+		/// Move the sites by `duration` and repair the triangulation
+		void advance(double duration);
+
+		/// Change the velocity of a site from the current time on
+		void setVelocity(uint32_t site, const Point & velocity);
+
+		/// Time since the start
+		double time() const;
+
+		/// Number of flips since the start
+		size_t flipCount() const;
+
+		/// Current positions of the sites
+		const std::vector<Point> & getSites() const;
+
+		/// Voronoi edges of the current positions clipped to the bounding box
+		std::list<Edge> getEdges() const;
+
+		/// Counter-clockwise triangles [a0, b0, c0, a1, b1, c1, ...] of the sites
+		std::vector<uint32_t> getTriangles() const;
+
+	private:
+		/// The edge opposite to vertex `edge` of `triangle` fails at `time`
+		///
+		/// The certificate is stale if either triangle has changed since it was computed
+		/// or if the edge has got another neighbour.
+		struct Certificate
+		{
+			double time;
+			uint32_t triangle;
+			uint32_t edge;
+			uint32_t neighbour;
+			uint32_t version;
+			uint32_t neighbourVersion;
+		};
+
+		/// Earliest certificate on the top
+		struct LaterCertificate
+		{
+			bool operator()(const Certificate & left, const Certificate & right) const;
+		};
+
+		Triangulation _triangulation;
+
+		/// Position of a point at time `t` is `origin + velocity * t`
+		std::vector<Point> _origins;
+		std::vector<Point> _velocities;
+
+		/// Sites which have had a non-zero velocity, their positions are updated by `advance`
+		std::vector<uint32_t> _movingSites;
+		std::vector<bool> _isMoving;
+
+		/// Changes of each triangle, the certificates of the older versions are stale
+		std::vector<uint32_t> _versions;
+
+		/// One triangle of every point, the start of the walk around it
+		std::vector<uint32_t> _pointTriangles;
+
+		std::priority_queue<Certificate, std::vector<Certificate>, LaterCertificate> _certificates;
+		double _time;
+		size_t _flipCount;
+
+		void _scheduleAll();
+		void _schedule(uint32_t triangle, uint32_t edge);
+		void _flip(uint32_t triangle, uint32_t edge);
+		void _updatePositions();
+	};
+}
+
+
+// Implementation
+
+inline bool Voronoi::KineticDiagram::LaterCertificate::operator()(const Certificate & left, const Certificate & right) const
+{
+	return left.time > right.time;
+}
+
+
+inline double Voronoi::KineticDiagram::time() const
+{
+	return _time;
+}
+
+
+inline size_t Voronoi::KineticDiagram::flipCount() const
+{
+	return _flipCount;
+}
+
+
+inline const std::vector<Voronoi::Point> & Voronoi::KineticDiagram::getSites() const
+{
+	return _triangulation.getSites();
+}
+
+
+inline std::list<Voronoi::Edge> Voronoi::KineticDiagram::getEdges() const
+{
+	return _triangulation.getEdges();
+}
+
+
+inline std::vector<uint32_t> Voronoi::KineticDiagram::getTriangles() const
+{
+	return _triangulation.getTriangles();
+}
+
+
+#endif  // KINETIC_H
@@ -0,0 +1,136 @@
+#include "memoryresource.h"
+#include <algorithm>
+#include <cstdint>
+#include <new>
+#include <utility>
+
+
+namespace
+{
+	class NewDeleteResource : public Voronoi::MemoryResource
+	{
+	protected:
+		void * _allocate(size_t bytes, size_t /*alignment*/) override
+		{
+			// `operator new` is aligned for any fundamental type, which covers all types of the library
+			return ::operator new(bytes);
+		}
+
+		void _deallocate(void * pointer, size_t /*bytes*/, size_t /*alignment*/) override
+		{
+			::operator delete(pointer);
+		}
+	};
+
+
+	/// Return the first address at or after `pointer` aligned to `alignment`
+	char * alignUp(char * pointer, size_t alignment)
+	{
+		const uintptr_t address = reinterpret_cast<uintptr_t>(pointer);
+		return pointer + ((alignment - address % alignment) % alignment);
+	}
+}  // end of anonymous namespace
+
+
+Voronoi::MemoryResource * Voronoi::newDeleteResource()
+{
+	static NewDeleteResource resource;
+	return &resource;
+}
+
+
+Voronoi::MonotonicBuffer::MonotonicBuffer(size_t blockSize, MemoryResource * upstream) :
+	_upstream(upstream),
+	_blocks(nullptr),
+	_current(nullptr),
+	_available(0),
+	_blockSize(std::max<size_t>(blockSize, 2 * sizeof(Block))),
+	_nextBlockSize(_blockSize),
+	_upstreamSize(0),
+	_initialBuffer(nullptr),
+	_initialSize(0)
+{
+}
+
+
+Voronoi::MonotonicBuffer::MonotonicBuffer(void * buffer, size_t size, MemoryResource * upstream) :
+	_upstream(upstream),
+	_blocks(nullptr),
+	_current(static_cast<char *>(buffer)),
+	_available(size),
+	_blockSize(std::max<size_t>(size, 2 * sizeof(Block))),
+	_nextBlockSize(_blockSize),
+	_upstreamSize(0),
+	_initialBuffer(buffer),
+	_initialSize(size)
+{
+}
+
+
+Voronoi::MonotonicBuffer::~MonotonicBuffer()
+{
+	while (_blocks) {
+		Block * previous = _blocks->previous;
+		_upstream->deallocate(_blocks, _blocks->size);
+		_blocks = previous;
+	}
+}
+
+
+void Voronoi::MonotonicBuffer::release()
+{
+	Block * largest = nullptr;
+	while (_blocks) {
+		Block * previous = _blocks->previous;
+		if (!largest || _blocks->size > largest->size) {
+			std::swap(largest, _blocks);
+		}
+		if (_blocks) {
+			_upstream->deallocate(_blocks, _blocks->size);
+		}
+		_blocks = previous;
+	}
+
+	// The initial buffer was too small if there is any block, so the block is used instead
+	if (largest) {
+		largest->previous = nullptr;
+		_blocks = largest;
+		_current = reinterpret_cast<char *>(largest + 1);
+		_available = largest->size - sizeof(Block);
+		_nextBlockSize = 2 * largest->size;
+		_upstreamSize = largest->size;
+	}
+	else {
+		_current = static_cast<char *>(_initialBuffer);
+		_available = _initialSize;
+		_nextBlockSize = _blockSize;
+		_upstreamSize = 0;
+	}
+}
+
+
+void * Voronoi::MonotonicBuffer::_allocate(size_t bytes, size_t alignment)
+{
+	char * aligned = alignUp(_current, alignment);
+	if (!_current || static_cast<size_t>(aligned - _current) + bytes > _available) {
+		// The blocks grow geometrically, so a diagram takes a few of them
+		const size_t size = std::max(_nextBlockSize, sizeof(Block) + bytes + alignment);
+		Block * block = static_cast<Block *>(_upstream->allocate(size));
+		block->previous = _blocks;
+		block->size = size;
+		_blocks = block;
+		_upstreamSize += size;
+		_nextBlockSize = 2 * size;
+		_current = reinterpret_cast<char *>(block + 1);
+		_available = size - sizeof(Block);
+		aligned = alignUp(_current, alignment);
+	}
+	_available -= static_cast<size_t>(aligned - _current) + bytes;
+	_current = aligned + bytes;
+	return aligned;
+}
+
+
+void Voronoi::MonotonicBuffer::_deallocate(void * /*pointer*/, size_t /*bytes*/, size_t /*alignment*/)
+{
+}
@@ -0,0 +1,261 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2015 Lukáš Bednařík l.bednarik@gmail.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef MEMORYRESOURCE_H
+#define MEMORYRESOURCE_H
+
+#include <cstddef>
+#include <memory>
+
+
+namespace Voronoi
+{
+	/// Source of memory for the containers of the generator
+	///
+	/// The interface follows `std::pmr::memory_resource`, which isn't available in C++11.
+	class MemoryResource
+	{
+	public:
+		virtual ~MemoryResource() {}
+
+		void * allocate(size_t bytes, size_t alignment = alignof(std::max_align_t));
+		void deallocate(void * pointer, size_t bytes, size_t alignment = alignof(std::max_align_t));
+
+		/// Return true if memory from one resource can be deallocated by the other one
+		bool isEqual(const MemoryResource & other) const;
+
+	protected:
+		virtual void * _allocate(size_t bytes, size_t alignment) = 0;
+		virtual void _deallocate(void * pointer, size_t bytes, size_t alignment) = 0;
+		virtual bool _isEqual(const MemoryResource & other) const;
+	};
+
+
+	/// Resource of the global `operator new` and `operator delete`, the default one
+	MemoryResource * newDeleteResource();
+
+
+	/// Memory handed out from big blocks, which are freed at once
+	///
+	/// Deallocation does nothing, so a whole diagram is freed at once by `release` or by the
+	/// destructor. Like `std::pmr::monotonic_buffer_resource` it isn't thread safe,
+	/// give each thread its own buffer.
+	class MonotonicBuffer : public MemoryResource
+	{
+	public:
+		/// The first block of `blockSize` bytes is taken from `upstream` on the first allocation
+		explicit MonotonicBuffer(size_t blockSize = 64 * 1024, MemoryResource * upstream = newDeleteResource());
+
+		/// Use the given buffer first, the buffer is not owned
+		MonotonicBuffer(void * buffer, size_t size, MemoryResource * upstream = newDeleteResource());
+
+		~MonotonicBuffer();
+
+		MonotonicBuffer(const MonotonicBuffer &) = delete;
+		MonotonicBuffer & operator=(const MonotonicBuffer &) = delete;
+
+		/// Free all allocations, return all blocks but the largest one to the upstream resource
+		///
+		/// The next allocations use the kept block, so after a few diagrams of similar size
+		/// the buffer stops taking memory from the upstream resource. The destructor returns all blocks.
+		void release();
+
+		/// Total size of the blocks taken from the upstream resource
+		size_t upstreamSize() const;
+
+	private:
+		/// Header in front of each upstream block, the blocks form a list
+		struct Block
+		{
+			Block * previous;
+			size_t size;
+		};
+
+		MemoryResource * _upstream;
+		Block * _blocks;
+		char * _current;
+		size_t _available;
+		size_t _blockSize;
+		size_t _nextBlockSize;
+		size_t _upstreamSize;
+		void * _initialBuffer;
+		size_t _initialSize;
+
+		void * _allocate(size_t bytes, size_t alignment) override;
+		void _deallocate(void * pointer, size_t bytes, size_t alignment) override;
+	};
+
+
+	/// Allocator of the standard containers which takes memory from a resource
+	///
+	/// The resource is selected at runtime, so containers with different resources have
+	/// the same type, like with `std::pmr::polymorphic_allocator`.
+	template <typename T>
+	class Allocator
+	{
+	public:
+		typedef T value_type;
+
+		Allocator(MemoryResource * resource = newDeleteResource());
+
+		template <typename U>
+		Allocator(const Allocator<U> & other);
+
+		T * allocate(size_t count);
+		void deallocate(T * pointer, size_t count);
+
+		MemoryResource * resource() const;
+
+	private:
+		MemoryResource * _resource;
+	};
+
+	template <typename T, typename U>
+	bool operator==(const Allocator<T> & left, const Allocator<U> & right);
+
+	template <typename T, typename U>
+	bool operator!=(const Allocator<T> & left, const Allocator<U> & right);
+
+
+	/// Deleter of `std::unique_ptr` for objects created in a resource
+	template <typename T>
+	struct ResourceDeleter
+	{
+		MemoryResource * resource;
+
+		void operator()(T * pointer) const;
+	};
+
+
+	/// Create an object in the resource, like `make_unique`
+	template <typename T, typename... Arguments>
+	std::unique_ptr<T, ResourceDeleter<T>> allocateUnique(MemoryResource * resource, Arguments && ... arguments);
+}
+
+
+// Implementation
+
+inline void * Voronoi::MemoryResource::allocate(size_t bytes, size_t alignment)
+{
+	return _allocate(bytes, alignment);
+}
+
+
+inline void Voronoi::MemoryResource::deallocate(void * pointer, size_t bytes, size_t alignment)
+{
+	_deallocate(pointer, bytes, alignment);
+}
+
+
+inline bool Voronoi::MemoryResource::isEqual(const MemoryResource & other) const
+{
+	return _isEqual(other);
+}
+
+
+inline bool Voronoi::MemoryResource::_isEqual(const MemoryResource & other) const
+{
+	return this == &other;
+}
+
+
+inline size_t Voronoi::MonotonicBuffer::upstreamSize() const
+{
+	return _upstreamSize;
+}
+
+
+template <typename T>
+inline Voronoi::Allocator<T>::Allocator(MemoryResource * resource) :
+	_resource(resource)
+{
+}
+
+
+template <typename T>
+template <typename U>
+inline Voronoi::Allocator<T>::Allocator(const Allocator<U> & other) :
+	_resource(other.resource())
+{
+}
+
+
+template <typename T>
+inline T * Voronoi::Allocator<T>::allocate(size_t count)
+{
+	return static_cast<T *>(_resource->allocate(count * sizeof(T), alignof(T)));
+}
+
+
+template <typename T>
+inline void Voronoi::Allocator<T>::deallocate(T * pointer, size_t count)
+{
+	_resource->deallocate(pointer, count * sizeof(T), alignof(T));
+}
+
+
+template <typename T>
+inline Voronoi::MemoryResource * Voronoi::Allocator<T>::resource() const
+{
+	return _resource;
+}
+
+
+template <typename T, typename U>
+inline bool Voronoi::operator==(const Allocator<T> & left, const Allocator<U> & right)
+{
+	return left.resource() == right.resource() || left.resource()->isEqual(*right.resource());
+}
+
+
+template <typename T, typename U>
+inline bool Voronoi::operator!=(const Allocator<T> & left, const Allocator<U> & right)
+{
+	return !(left == right);
+}
+
+
+template <typename T>
+inline void Voronoi::ResourceDeleter<T>::operator()(T * pointer) const
+{
+	pointer->~T();
+	resource->deallocate(pointer, sizeof(T), alignof(T));
+}
+
+
+template <typename T, typename... Arguments>
+inline std::unique_ptr<T, Voronoi::ResourceDeleter<T>> Voronoi::allocateUnique(MemoryResource * resource, Arguments && ... arguments)
+{
+	void * memory = resource->allocate(sizeof(T), alignof(T));
+	try {
+		T * object = new (memory) T(std::forward<Arguments>(arguments)...);
+		return std::unique_ptr<T, ResourceDeleter<T>>(object, ResourceDeleter<T>{ resource });
+	}
+	catch (...) {
+		resource->deallocate(memory, sizeof(T), alignof(T));
+		throw;
+	}
+}
+
+
+#endif  // MEMORYRESOURCE_H
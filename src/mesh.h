@@ -0,0 +1,93 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2015 Lukáš Bednařík l.bednarik@gmail.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef MESH_H
+#define MESH_H
+
+#include "point.h"
+#include "memoryresource.h"
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+
+namespace Voronoi
+{
+	/// Voronoi diagram as flat buffers ready for rendering
+	///
+	/// Every vertex is stored once and edges refer to vertices by index.
+	struct Mesh
+	{
+		/// The buffers are allocated from the resource
+		explicit Mesh(MemoryResource * resource = newDeleteResource());
+
+		/// Vertex coordinates [x0, y0, x1, y1, ...]
+		std::vector<double, Allocator<double>> vertices;
+
+		/// Vertex indices of the edge ends [begin0, end0, begin1, end1, ...]
+		std::vector<uint32_t, Allocator<uint32_t>> edges;
+
+		/// Sites of the edges [left0, right0, left1, right1, ...]
+		std::vector<uint32_t, Allocator<uint32_t>> sites;
+
+		/// Number of vertices
+		size_t vertexCount() const;
+
+		/// Number of edges
+		size_t edgeCount() const;
+
+		/// Return one vertex
+		Point vertex(size_t index) const;
+	};
+}
+
+
+// Implementation
+
+inline Voronoi::Mesh::Mesh(MemoryResource * resource) :
+	vertices(resource),
+	edges(resource),
+	sites(resource)
+{
+}
+
+
+inline size_t Voronoi::Mesh::vertexCount() const
+{
+	return vertices.size() / 2;
+}
+
+
+inline size_t Voronoi::Mesh::edgeCount() const
+{
+	return edges.size() / 2;
+}
+
+
+inline Voronoi::Point Voronoi::Mesh::vertex(size_t index) const
+{
+	return Point(vertices[2 * index], vertices[2 * index + 1]);
+}
+
+
+#endif  // MESH_H
@@ -0,0 +1,239 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2015 Lukáš Bednařík l.bednarik@gmail.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef SMALLGENERATOR_H
+#define SMALLGENERATOR_H
+
+#include "point.h"
+#include "edge.h"
+#include "boundingbox.h"
+#include "fixedvector.h"
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+
+
+namespace Voronoi
+{
+	/// Site count up to which `generateEdges` uses `SmallGenerator` instead of `Generator`
+	const size_t SmallSiteCount = 64;
+
+
+	/// Voronoi diagram of at most `N` sites with no heap allocation
+	///
+	/// Each cell starts as the bounding box and is clipped by the bisectors with the other
+	/// sites. This is quadratic, but for a few dozen sites it beats the sweep, whose setup
+	/// of the queues and lists dominates. The edges are clipped to the bounding box and have
+	/// the same orientation as the edges of `Generator`.
+	template <size_t N = SmallSiteCount>
+	class SmallGenerator
+	{
+	public:
+		typedef FixedVector<Edge, 3 * N> EdgeVector;
+
+		/// Throw `std::length_error` if more than `N` sites lie in the bounding box
+		SmallGenerator(const Point * sites, size_t count, const BoundingBox & boundingBox = BoundingBox());
+		SmallGenerator(const std::vector<Point> & sites, const BoundingBox & boundingBox = BoundingBox());
+
+		const EdgeVector & getEdges() const;
+
+	private:
+		/// Vertex of a cell with the site across the following side
+		struct Vertex
+		{
+			double x;
+			double y;
+			uint32_t neighbour;
+		};
+
+		/// A cell is a counter-clockwise polygon
+		typedef FixedVector<Vertex, N + 4> Polygon;
+
+		EdgeVector _edges;
+
+		void _generate(const Point * sites, size_t count, const BoundingBox & boundingBox);
+
+		/// Clip the polygon by the bisector of the center and the other site
+		///
+		/// @return false if the bisector doesn't cut the polygon, `clipped` is not valid then.
+		static bool _clip(const Polygon & polygon, Polygon & clipped, const Point & center,
+			const Point & other, uint32_t otherIndex);
+
+		/// Squared distance of the furthest vertex from the center
+		static double _radius2(const Polygon & polygon, const Point & center);
+	};
+}
+
+
+// Implementation
+
+template <size_t N>
+Voronoi::SmallGenerator<N>::SmallGenerator(const Point * sites, size_t count, const BoundingBox & boundingBox)
+{
+	_generate(sites, count, boundingBox);
+}
+
+
+template <size_t N>
+Voronoi::SmallGenerator<N>::SmallGenerator(const std::vector<Point> & sites, const BoundingBox & boundingBox)
+{
+	_generate(sites.data(), sites.size(), boundingBox);
+}
+
+
+template <size_t N>
+const typename Voronoi::SmallGenerator<N>::EdgeVector & Voronoi::SmallGenerator<N>::getEdges() const
+{
+	return _edges;
+}
+
+
+template <size_t N>
+void Voronoi::SmallGenerator<N>::_generate(const Point * sites, size_t count, const BoundingBox & boundingBox)
+{
+	const double Epsilon = 1e-12;
+
+	// Sites outside of the box are ignored like in `Generator`
+	FixedVector<uint32_t, N> inside;
+	for (uint32_t i = 0; i < count; ++i) {
+		if (boundingBox.contains(sites[i])) {
+			inside.push_back(i);
+		}
+	}
+
+	// Neighbours are searched by the distance along x
+	std::sort(inside.begin(), inside.end(), [sites](uint32_t left, uint32_t right) {
+		return sites[left].x() < sites[right].x();
+	});
+
+	Polygon polygons[2];
+	for (size_t position = 0; position < inside.size(); ++position) {
+		const uint32_t site = inside[position];
+		const Point & center = sites[site];
+		Polygon * polygon = &polygons[0];
+		Polygon * clipped = &polygons[1];
+		polygon->clear();
+		polygon->push_back(Vertex{ boundingBox.MinX, boundingBox.MinY, NoVertex });
+		polygon->push_back(Vertex{ boundingBox.MaxX, boundingBox.MinY, NoVertex });
+		polygon->push_back(Vertex{ boundingBox.MaxX, boundingBox.MaxY, NoVertex });
+		polygon->push_back(Vertex{ boundingBox.MinX, boundingBox.MaxY, NoVertex });
+
+		// Walk to both sides in x, the nearer side first. A site further than twice the distance
+		// of the furthest vertex of the cell can't cut it, and neither can the sites beyond it.
+		double radius2 = _radius2(*polygon, center);
+		size_t left = position;
+		size_t right = position + 1;
+		while (true) {
+			const double leftDistance = left > 0 ? center.x() - sites[inside[left - 1]].x() : 0.0;
+			const double rightDistance = right < inside.size() ? sites[inside[right]].x() - center.x() : 0.0;
+			const bool canLeft = left > 0 && leftDistance * leftDistance < 4.0 * radius2;
+			const bool canRight = right < inside.size() && rightDistance * rightDistance < 4.0 * radius2;
+			if (!canLeft && !canRight) {
+				break;
+			}
+			const uint32_t other = canLeft && (!canRight || leftDistance < rightDistance) ? inside[--left] : inside[right++];
+			const double dx = sites[other].x() - center.x();
+			const double dy = sites[other].y() - center.y();
+			const double distance2 = dx * dx + dy * dy;
+			if (distance2 == 0.0 || distance2 >= 4.0 * radius2) {
+				continue;
+			}
+			if (_clip(*polygon, *clipped, center, sites[other], other)) {
+				std::swap(polygon, clipped);
+				radius2 = _radius2(*polygon, center);
+			}
+		}
+
+		// Each edge is reported by the cell of the smaller site. The end lies on the right
+		// of the line from the left site to the right one, that is against the polygon order.
+		const size_t size = polygon->size();
+		for (size_t i = 0; i < size; ++i) {
+			const Vertex & end = (*polygon)[i];
+			const Vertex & begin = (*polygon)[i + 1 == size ? 0 : i + 1];
+			if (end.neighbour == NoVertex || end.neighbour < site) {
+				continue;
+			}
+			if (std::abs(begin.x - end.x) < Epsilon && std::abs(begin.y - end.y) < Epsilon) {
+				continue;
+			}
+			_edges.emplace_back(site, end.neighbour);
+			_edges.back().setBegin(Point(begin.x, begin.y));
+			_edges.back().setEnd(Point(end.x, end.y));
+		}
+	}
+}
+
+
+template <size_t N>
+bool Voronoi::SmallGenerator<N>::_clip(const Polygon & polygon, Polygon & clipped, const Point & center,
+	const Point & other, uint32_t otherIndex)
+{
+	// Keep the side of the bisector closer to the center
+	const double normalX = other.x() - center.x();
+	const double normalY = other.y() - center.y();
+	const double offset = (normalX * (other.x() + center.x()) + normalY * (other.y() + center.y())) / 2.0;
+	const size_t size = polygon.size();
+	double sides[N + 4];
+	bool isCut = false;
+	for (size_t i = 0; i < size; ++i) {
+		sides[i] = polygon[i].x * normalX + polygon[i].y * normalY - offset;
+		isCut = isCut || sides[i] > 0.0;
+	}
+	if (!isCut) {
+		return false;
+	}
+
+	clipped.clear();
+	for (size_t i = 0; i < size; ++i) {
+		const size_t next = i + 1 == size ? 0 : i + 1;
+		if (sides[i] <= 0.0) {
+			clipped.push_back(polygon[i]);
+		}
+		if ((sides[i] <= 0.0) != (sides[next] <= 0.0)) {
+			const double t = sides[i] / (sides[i] - sides[next]);
+			clipped.push_back(Vertex{ polygon[i].x + (polygon[next].x - polygon[i].x) * t,
+				polygon[i].y + (polygon[next].y - polygon[i].y) * t, sides[i] <= 0.0 ? otherIndex : polygon[i].neighbour });
+		}
+	}
+	return true;
+}
+
+
+template <size_t N>
+double Voronoi::SmallGenerator<N>::_radius2(const Polygon & polygon, const Point & center)
+{
+	double radius2 = 0.0;
+	for (const auto & vertex : polygon) {
+		const double dx = vertex.x - center.x();
+		const double dy = vertex.y - center.y();
+		radius2 = std::max(radius2, dx * dx + dy * dy);
+	}
+	return radius2;
+}
+
+
+#endif  // SMALLGENERATOR_H
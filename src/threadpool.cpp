@@ -0,0 +1,128 @@
+#include "threadpool.h"
+#include <exception>
+
+
+/// Tasks of one call of `run`
+struct Voronoi::ThreadPool::Batch
+{
+	size_t remaining;
+	std::exception_ptr error;
+};
+
+
+Voronoi::ThreadPool::ThreadPool(unsigned threadCount) :
+	_isStopping(false)
+{
+	if (threadCount == 0) {
+		threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+	}
+	for (unsigned i = 1; i < threadCount; ++i) {
+		_threads.emplace_back(&ThreadPool::_work, this);
+	}
+}
+
+
+Voronoi::ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_isStopping = true;
+	}
+	_taskAdded.notify_all();
+	for (auto & thread : _threads) {
+		thread.join();
+	}
+	if (_postThread.joinable()) {
+		_postThread.join();
+	}
+}
+
+
+void Voronoi::ThreadPool::run(std::vector<std::function<void()>> & tasks)
+{
+	if (tasks.empty()) {
+		return;
+	}
+
+	Batch batch;
+	batch.remaining = tasks.size();
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		for (auto & task : tasks) {
+			auto * function = &task;
+			_tasks.emplace_back([this, function, &batch]() {
+				std::exception_ptr error;
+				try {
+					(*function)();
+				}
+				catch (...) {
+					error = std::current_exception();
+				}
+				std::lock_guard<std::mutex> lock(_mutex);
+				if (error && !batch.error) {
+					batch.error = error;
+				}
+				--batch.remaining;
+				_taskFinished.notify_all();
+			});
+		}
+	}
+	_taskAdded.notify_all();
+
+	// Help with the tasks until the batch is finished
+	std::unique_lock<std::mutex> lock(_mutex);
+	while (batch.remaining > 0) {
+		if (!_tasks.empty()) {
+			auto task = std::move(_tasks.front());
+			_tasks.pop_front();
+			lock.unlock();
+			task();
+			lock.lock();
+		}
+		else {
+			_taskFinished.wait(lock);
+		}
+	}
+	if (batch.error) {
+		std::rethrow_exception(batch.error);
+	}
+}
+
+
+void Voronoi::ThreadPool::post(std::function<void()> task)
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_postedTasks.push_back(std::move(task));
+		if (_threads.empty() && !_postThread.joinable()) {
+			_postThread = std::thread(&ThreadPool::_work, this);
+		}
+	}
+	_taskAdded.notify_one();
+}
+
+
+void Voronoi::ThreadPool::_work()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	while (true) {
+		_taskAdded.wait(lock, [this]() { return _isStopping || !_tasks.empty() || !_postedTasks.empty(); });
+
+		// Tasks of `run` first, their callers are waiting
+		std::function<void()> task;
+		if (!_tasks.empty()) {
+			task = std::move(_tasks.front());
+			_tasks.pop_front();
+		}
+		else if (!_postedTasks.empty()) {
+			task = std::move(_postedTasks.front());
+			_postedTasks.pop_front();
+		}
+		else {
+			return;  // stopping
+		}
+		lock.unlock();
+		task();
+		lock.lock();
+	}
+}
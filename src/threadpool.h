@@ -0,0 +1,159 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2015 Lukáš Bednařík l.bednarik@gmail.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <vector>
+#include <deque>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <algorithm>
+#include <cstddef>
+
+
+namespace Voronoi
+{
+	/// Fixed set of threads running batches of tasks
+	///
+	/// The calling thread takes part in the work, so a pool of `n` threads starts `n - 1`
+	/// threads and a pool of one thread runs the batches of `run` in the caller.
+	class ThreadPool
+	{
+	public:
+		/// Zero means the number of cores
+		explicit ThreadPool(unsigned threadCount = 0);
+		~ThreadPool();
+
+		ThreadPool(const ThreadPool &) = delete;
+		ThreadPool & operator=(const ThreadPool &) = delete;
+
+		/// Number of threads including the calling one
+		unsigned size() const;
+
+		/// Run all tasks and wait for them
+		///
+		/// The first exception thrown by a task is rethrown here.
+		void run(std::vector<std::function<void()>> & tasks);
+
+		/// Queue the task and return without waiting for it
+		///
+		/// The task must not throw. Only the pool threads take the posted tasks, a thread
+		/// helping in `run` doesn't, so a pool of one thread starts a thread for them on the
+		/// first call. Tasks still queued when the pool is destroyed are run first.
+		void post(std::function<void()> task);
+
+		/// Call `function(begin, end)` for chunks of range [0, count) and wait for them
+		template <typename Function>
+		void parallelFor(size_t count, Function function);
+
+	private:
+		struct Batch;
+
+		std::vector<std::thread> _threads;
+		std::deque<std::function<void()>> _tasks;
+		std::deque<std::function<void()>> _postedTasks;  ///< Taken after the tasks of `run`
+		std::thread _postThread;  ///< Started by `post` if there are no other threads
+		std::mutex _mutex;
+		std::condition_variable _taskAdded;
+		std::condition_variable _taskFinished;
+		bool _isStopping;
+
+		void _work();
+	};
+
+
+	/// Sort the range in parallel chunks and merge them
+	///
+	/// Null pool sorts in the calling thread.
+	template <typename Iterator, typename Compare>
+	void parallelSort(ThreadPool * pool, Iterator first, Iterator last, Compare compare);
+}
+
+
+// Implementation
+
+inline unsigned Voronoi::ThreadPool::size() const
+{
+	return static_cast<unsigned>(_threads.size() + 1);
+}
+
+
+template <typename Function>
+void Voronoi::ThreadPool::parallelFor(size_t count, Function function)
+{
+	// More chunks than threads even out uneven chunks
+	const size_t chunkCount = std::min<size_t>(count, 4 * size());
+	std::vector<std::function<void()>> tasks;
+	tasks.reserve(chunkCount);
+	for (size_t chunk = 0; chunk < chunkCount; ++chunk) {
+		const size_t begin = count * chunk / chunkCount;
+		const size_t end = count * (chunk + 1) / chunkCount;
+		tasks.emplace_back([&function, begin, end]() { function(begin, end); });
+	}
+	run(tasks);
+}
+
+
+template <typename Iterator, typename Compare>
+void Voronoi::parallelSort(ThreadPool * pool, Iterator first, Iterator last, Compare compare)
+{
+	const size_t count = static_cast<size_t>(last - first);
+	const size_t chunkCount = pool ? std::min<size_t>(pool->size(), count / 1024 + 1) : 1;
+	if (chunkCount <= 1) {
+		std::sort(first, last, compare);
+		return;
+	}
+
+	// Sort the chunks, then merge the neighbouring runs until one is left
+	std::vector<size_t> bounds;
+	for (size_t chunk = 0; chunk <= chunkCount; ++chunk) {
+		bounds.push_back(count * chunk / chunkCount);
+	}
+	pool->parallelFor(chunkCount, [&](size_t begin, size_t end) {
+		for (size_t chunk = begin; chunk < end; ++chunk) {
+			std::sort(first + bounds[chunk], first + bounds[chunk + 1], compare);
+		}
+	});
+	while (bounds.size() > 2) {
+		const size_t mergeCount = (bounds.size() - 1) / 2;
+		pool->parallelFor(mergeCount, [&](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; ++i) {
+				std::inplace_merge(first + bounds[2 * i], first + bounds[2 * i + 1], first + bounds[2 * i + 2], compare);
+			}
+		});
+		std::vector<size_t> merged;
+		for (size_t i = 0; i < bounds.size(); i += 2) {
+			merged.push_back(bounds[i]);
+		}
+		if (merged.back() != bounds.back()) {
+			merged.push_back(bounds.back());
+		}
+		bounds.swap(merged);
+	}
+}
+
+
+#endif  // THREADPOOL_H
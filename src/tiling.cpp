@@ -0,0 +1,476 @@
+#include "tiling.h"
+#include "voronoi.h"
+#include "geometry.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+
+namespace
+{
+	/// Automatic halo as a multiple of the average site distance
+	const double HaloFactor = 3.0;
+
+	/// Tolerance of the seam points relative to the size of the bounding box
+	const double SeamTolerance = 1e-9;
+
+	const char * const TileHeader = "voronoi-tile";
+	const char * const EdgesHeader = "voronoi-edges";
+	const int FileVersion = 1;
+
+
+	/// Sites of one tile as stored in the tile file
+	struct Tile
+	{
+		Voronoi::BoundingBox box;
+		Voronoi::BoundingBox halo;
+		std::vector<uint32_t> indices;  ///< Index of each site in the input vector
+		std::vector<Voronoi::Point> sites;
+	};
+
+
+	/// Edge end lying on a seam between two tiles
+	struct SeamEnd
+	{
+		uint32_t low;   ///< Smaller site index of the edge
+		uint32_t high;  ///< Bigger site index of the edge
+		double x;
+		double y;
+		size_t piece;
+		bool isEnd;
+	};
+
+
+	/// Prefix of the tile files unique to this run, the directory may be shared by other runs and nodes
+	std::string runId()
+	{
+		static std::atomic<unsigned> counter(0);
+#ifdef _WIN32
+		const long long process = _getpid();
+#else
+		const long long process = getpid();
+#endif
+		std::ostringstream id;
+		id << process << "_" << std::chrono::system_clock::now().time_since_epoch().count() << "_" << counter++;
+		return id.str();
+	}
+
+
+	std::string tilePath(const std::string & directory, const std::string & run, uint32_t row, uint32_t column,
+		const char * extension)
+	{
+		std::ostringstream path;
+		path << directory << "/tile_" << run << "_" << row << "_" << column << extension;
+		return path.str();
+	}
+
+
+	/// Quote a path as one argument of the worker command
+	std::string quoteArgument(const std::string & argument)
+	{
+#ifdef _WIN32
+		// The command interpreter expands the variables and ends the argument at a quote
+		if (argument.find_first_of("\"%") != std::string::npos) {
+			throw std::invalid_argument("Path " + argument + " can't be passed to the worker command!");
+		}
+		return "\"" + argument + "\"";
+#else
+		// Nothing is special within single quotes, a single quote ends them
+		std::string quoted = "'";
+		for (char character : argument) {
+			if (character == '\'') {
+				quoted += "'\\''";
+			}
+			else {
+				quoted += character;
+			}
+		}
+		return quoted + "'";
+#endif
+	}
+
+
+	void checkHeader(std::istream & stream, const char * header, const std::string & path)
+	{
+		std::string name;
+		int version = 0;
+		stream >> name >> version;
+		if (!stream || name != header || version != FileVersion) {
+			throw std::runtime_error("Invalid file " + path);
+		}
+	}
+
+
+	void writeBox(std::ostream & stream, const Voronoi::BoundingBox & box)
+	{
+		stream << box.MinX << " " << box.MaxX << " " << box.MinY << " " << box.MaxY << "\n";
+	}
+
+
+	Voronoi::BoundingBox readBox(std::istream & stream)
+	{
+		double minX, maxX, minY, maxY;
+		stream >> minX >> maxX >> minY >> maxY;
+		return Voronoi::BoundingBox(minX, maxX, minY, maxY);
+	}
+
+
+	void writeTile(const std::string & path, const Tile & tile)
+	{
+		std::ofstream stream(path);
+		stream.precision(std::numeric_limits<double>::max_digits10);
+		stream << TileHeader << " " << FileVersion << "\n";
+		writeBox(stream, tile.box);
+		writeBox(stream, tile.halo);
+		stream << tile.sites.size() << "\n";
+		for (size_t i = 0; i < tile.sites.size(); ++i) {
+			stream << tile.indices[i] << " " << tile.sites[i].x() << " " << tile.sites[i].y() << "\n";
+		}
+		if (!stream) {
+			throw std::runtime_error("Can't write file " + path);
+		}
+	}
+
+
+	Tile readTile(const std::string & path)
+	{
+		std::ifstream stream(path);
+		checkHeader(stream, TileHeader, path);
+		Tile tile;
+		tile.box = readBox(stream);
+		tile.halo = readBox(stream);
+		size_t count = 0;
+		stream >> count;
+		tile.indices.reserve(count);
+		tile.sites.reserve(count);
+		for (size_t i = 0; i < count && stream; ++i) {
+			uint32_t index;
+			double x, y;
+			stream >> index >> x >> y;
+			tile.indices.push_back(index);
+			tile.sites.emplace_back(x, y);
+		}
+		if (!stream) {
+			throw std::runtime_error("Can't read file " + path);
+		}
+		return tile;
+	}
+
+
+	void writeEdges(const std::string & path, const std::vector<Voronoi::Edge> & edges)
+	{
+		std::ofstream stream(path);
+		stream.precision(std::numeric_limits<double>::max_digits10);
+		stream << EdgesHeader << " " << FileVersion << "\n" << edges.size() << "\n";
+		for (const auto & edge : edges) {
+			stream << edge.leftSite() << " " << edge.rightSite() << " "
+				<< edge.begin().x() << " " << edge.begin().y() << " "
+				<< edge.end().x() << " " << edge.end().y() << "\n";
+		}
+		if (!stream) {
+			throw std::runtime_error("Can't write file " + path);
+		}
+	}
+
+
+	void readEdges(const std::string & path, std::vector<Voronoi::Edge> & edges)
+	{
+		std::ifstream stream(path);
+		checkHeader(stream, EdgesHeader, path);
+		size_t count = 0;
+		stream >> count;
+		for (size_t i = 0; i < count && stream; ++i) {
+			uint32_t left, right;
+			double beginX, beginY, endX, endY;
+			stream >> left >> right >> beginX >> beginY >> endX >> endY;
+			edges.emplace_back(left, right);
+			edges.back().setBegin(Voronoi::Point(beginX, beginY));
+			edges.back().setEnd(Voronoi::Point(endX, endY));
+		}
+		if (!stream) {
+			throw std::runtime_error("Can't read file " + path);
+		}
+	}
+
+
+	/// Return true if the point lies on a side of the tile shared with another tile
+	bool isOnSeam(const Voronoi::Point & point, const Voronoi::BoundingBox & tile,
+		const Voronoi::BoundingBox & boundingBox, double tolerance)
+	{
+		return (tile.MinX > boundingBox.MinX && std::abs(point.x() - tile.MinX) < tolerance) ||
+			(tile.MaxX < boundingBox.MaxX && std::abs(point.x() - tile.MaxX) < tolerance) ||
+			(tile.MinY > boundingBox.MinY && std::abs(point.y() - tile.MinY) < tolerance) ||
+			(tile.MaxY < boundingBox.MaxY && std::abs(point.y() - tile.MaxY) < tolerance);
+	}
+
+
+	size_t findRoot(std::vector<size_t> & parents, size_t piece)
+	{
+		while (parents[piece] != piece) {
+			parents[piece] = parents[parents[piece]];
+			piece = parents[piece];
+		}
+		return piece;
+	}
+}  // end of anonymous namespace
+
+
+Voronoi::TiledGenerator::TiledGenerator(const std::vector<Point> & sites, const BoundingBox & boundingBox,
+		const TilingOptions & options) :
+	_sites(sites),
+	_seamMismatches(0)
+{
+	if (boundingBox.Periodic) {
+		throw std::domain_error("Periodic bounding box can't be tiled!");
+	}
+	if (options.Columns == 0 || options.Rows == 0) {
+		throw std::domain_error("Tiling needs at least one tile!");
+	}
+
+	double halo = options.Halo;
+	if (halo <= 0.0) {
+		const auto count = std::count_if(sites.begin(), sites.end(), [&boundingBox](const Point & site) {
+			return boundingBox.contains(site);
+		});
+		const double n = static_cast<double>(std::max<ptrdiff_t>(count, 1));
+		halo = HaloFactor * std::sqrt(boundingBox.width() * boundingBox.height() / n);
+	}
+
+	// Split the box, the last row and column end exactly at the box
+	const double tileWidth = boundingBox.width() / options.Columns;
+	const double tileHeight = boundingBox.height() / options.Rows;
+	std::vector<Tile> tileSites(static_cast<size_t>(options.Columns) * options.Rows);
+	for (uint32_t row = 0; row < options.Rows; ++row) {
+		for (uint32_t column = 0; column < options.Columns; ++column) {
+			const double maxX = column + 1 == options.Columns ? boundingBox.MaxX : boundingBox.MinX + (column + 1) * tileWidth;
+			const double maxY = row + 1 == options.Rows ? boundingBox.MaxY : boundingBox.MinY + (row + 1) * tileHeight;
+			Tile & tile = tileSites[row * options.Columns + column];
+			tile.box = BoundingBox(boundingBox.MinX + column * tileWidth, maxX, boundingBox.MinY + row * tileHeight, maxY);
+			tile.halo = BoundingBox(std::max(tile.box.MinX - halo, boundingBox.MinX), std::min(tile.box.MaxX + halo, boundingBox.MaxX),
+				std::max(tile.box.MinY - halo, boundingBox.MinY), std::min(tile.box.MaxY + halo, boundingBox.MaxY));
+		}
+	}
+
+	// Bin the sites in one pass. Only the tiles in the halo distance are tested, one more
+	// tile on each side covers the rounding of the division.
+	auto tileRange = [](double low, double high, double min, double size, uint32_t count, uint32_t & first, uint32_t & last) {
+		const double lowTile = std::floor((low - min) / size) - 1.0;
+		const double highTile = std::floor((high - min) / size) + 1.0;
+		first = static_cast<uint32_t>(std::max(lowTile, 0.0));
+		last = static_cast<uint32_t>(std::min(highTile, count - 1.0));
+	};
+	for (uint32_t i = 0; i < sites.size(); ++i) {
+		const Point & site = sites[i];
+		if (!boundingBox.contains(site)) {
+			continue;
+		}
+		uint32_t firstColumn, lastColumn, firstRow, lastRow;
+		tileRange(site.x() - halo, site.x() + halo, boundingBox.MinX, tileWidth, options.Columns, firstColumn, lastColumn);
+		tileRange(site.y() - halo, site.y() + halo, boundingBox.MinY, tileHeight, options.Rows, firstRow, lastRow);
+		for (uint32_t row = firstRow; row <= lastRow; ++row) {
+			for (uint32_t column = firstColumn; column <= lastColumn; ++column) {
+				Tile & tile = tileSites[row * options.Columns + column];
+				if (tile.halo.contains(site)) {
+					tile.indices.push_back(i);
+					tile.sites.push_back(site);
+				}
+			}
+		}
+	}
+
+	// Write the tiles, the sites of a tile are freed once it is written
+	const std::string run = runId();
+	std::vector<BoundingBox> tiles;
+	std::vector<std::string> inputs;
+	std::vector<std::string> outputs;
+	std::vector<std::string> commands;
+	for (uint32_t row = 0; row < options.Rows; ++row) {
+		for (uint32_t column = 0; column < options.Columns; ++column) {
+			Tile & tile = tileSites[row * options.Columns + column];
+			tiles.push_back(tile.box);
+			inputs.push_back(tilePath(options.Directory, run, row, column, ".in"));
+			outputs.push_back(tilePath(options.Directory, run, row, column, ".out"));
+			if (!options.WorkerCommand.empty()) {
+				commands.push_back(options.WorkerCommand + " " + quoteArgument(inputs.back()) + " " +
+					quoteArgument(outputs.back()));
+			}
+			writeTile(inputs.back(), tile);
+			std::vector<uint32_t>().swap(tile.indices);
+			std::vector<Point>().swap(tile.sites);
+		}
+	}
+
+	// Run the workers, each thread waits for one worker process at a time
+	const unsigned cores = std::max(std::thread::hardware_concurrency(), 1u);
+	const size_t workerCount = std::min<size_t>(options.Processes ? options.Processes : cores, tiles.size());
+	std::atomic<size_t> nextTile(0);
+	std::vector<std::exception_ptr> errors(tiles.size());
+	auto work = [&]() {
+		for (size_t i = nextTile++; i < tiles.size(); i = nextTile++) {
+			try {
+				if (options.WorkerCommand.empty()) {
+					runTileWorker(inputs[i], outputs[i]);
+				}
+				else if (std::system(commands[i].c_str()) != 0) {
+					throw std::runtime_error("Worker failed: " + commands[i]);
+				}
+			}
+			catch (...) {
+				errors[i] = std::current_exception();
+			}
+		}
+	};
+	std::vector<std::thread> workers;
+	for (size_t i = 0; i < workerCount; ++i) {
+		workers.emplace_back(work);
+	}
+	for (auto & worker : workers) {
+		worker.join();
+	}
+
+	// Collect the results
+	std::vector<Edge> pieces;
+	std::vector<BoundingBox> pieceTiles;
+	std::exception_ptr error;
+	for (size_t i = 0; i < tiles.size(); ++i) {
+		std::remove(inputs[i].c_str());
+		try {
+			if (errors[i]) {
+				std::rethrow_exception(errors[i]);
+			}
+			if (!error) {
+				readEdges(outputs[i], pieces);
+				pieceTiles.resize(pieces.size(), tiles[i]);
+			}
+		}
+		catch (...) {
+			error = std::current_exception();
+		}
+		std::remove(outputs[i].c_str());
+	}
+	if (error) {
+		std::rethrow_exception(error);
+	}
+	_merge(pieces, pieceTiles, boundingBox);
+}
+
+
+void Voronoi::TiledGenerator::_merge(const std::vector<Edge> & pieces, const std::vector<BoundingBox> & tiles,
+	const BoundingBox & boundingBox)
+{
+	// Gather the ends on the seams
+	const double tolerance = SeamTolerance * std::max(boundingBox.width(), boundingBox.height());
+	std::vector<SeamEnd> seamEnds;
+	for (size_t i = 0; i < pieces.size(); ++i) {
+		const Edge & piece = pieces[i];
+		const uint32_t low = std::min(piece.leftSite(), piece.rightSite());
+		const uint32_t high = std::max(piece.leftSite(), piece.rightSite());
+		if (isOnSeam(piece.begin(), tiles[i], boundingBox, tolerance)) {
+			seamEnds.push_back(SeamEnd{ low, high, piece.begin().x(), piece.begin().y(), i, false });
+		}
+		if (isOnSeam(piece.end(), tiles[i], boundingBox, tolerance)) {
+			seamEnds.push_back(SeamEnd{ low, high, piece.end().x(), piece.end().y(), i, true });
+		}
+	}
+
+	// Pieces of one edge meet at the same point of the seam
+	std::sort(seamEnds.begin(), seamEnds.end(), [](const SeamEnd & left, const SeamEnd & right) {
+		if (left.low != right.low) {
+			return left.low < right.low;
+		}
+		if (left.high != right.high) {
+			return left.high < right.high;
+		}
+		return left.x < right.x || (left.x == right.x && left.y < right.y);
+	});
+	std::vector<size_t> parents(pieces.size());
+	for (size_t i = 0; i < parents.size(); ++i) {
+		parents[i] = i;
+	}
+	std::vector<char> joined(2 * pieces.size(), 0);  // [begin, end] of each piece
+	for (size_t i = 0; i < seamEnds.size(); ++i) {
+		const SeamEnd & first = seamEnds[i];
+		if (i + 1 < seamEnds.size()) {
+			const SeamEnd & second = seamEnds[i + 1];
+			if (first.low == second.low && first.high == second.high && first.piece != second.piece &&
+					std::abs(first.x - second.x) < tolerance && std::abs(first.y - second.y) < tolerance) {
+				joined[2 * first.piece + first.isEnd] = 1;
+				joined[2 * second.piece + second.isEnd] = 1;
+				parents[findRoot(parents, first.piece)] = findRoot(parents, second.piece);
+				++i;
+				continue;
+			}
+		}
+		++_seamMismatches;
+	}
+
+	// Join the pieces into edges, keep the pieces which don't form a single edge
+	std::vector<std::vector<size_t>> groups(pieces.size());
+	for (size_t i = 0; i < pieces.size(); ++i) {
+		groups[findRoot(parents, i)].push_back(i);
+	}
+	for (const auto & group : groups) {
+		if (group.empty()) {
+			continue;
+		}
+		std::vector<Point> ends;
+		for (size_t piece : group) {
+			if (!joined[2 * piece]) {
+				ends.push_back(pieces[piece].begin());
+			}
+			if (!joined[2 * piece + 1]) {
+				ends.push_back(pieces[piece].end());
+			}
+		}
+		if (group.size() == 1 || ends.size() != 2) {
+			for (size_t piece : group) {
+				_edges.push_back(pieces[piece]);
+			}
+			continue;
+		}
+
+		// The end lies in the direction of the edge from the begin
+		const Edge & piece = pieces[group.front()];
+		const Point & left = _sites[piece.leftSite()];
+		const Point & right = _sites[piece.rightSite()];
+		const Point direction(right.y() - left.y(), left.x() - right.x());
+		const Point delta = ends[1] - ends[0];
+		const bool isForward = delta.x() * direction.x() + delta.y() * direction.y() >= 0.0;
+		_edges.emplace_back(piece.leftSite(), piece.rightSite());
+		_edges.back().setBegin(isForward ? ends[0] : ends[1]);
+		_edges.back().setEnd(isForward ? ends[1] : ends[0]);
+	}
+}
+
+
+void Voronoi::runTileWorker(const std::string & input, const std::string & output)
+{
+	const Tile tile = readTile(input);
+	Generator generator(tile.sites, tile.halo);
+
+	std::vector<Edge> edges;
+	for (const auto & edge : generator.getEdges()) {
+		Edge clipped(tile.indices[edge.leftSite()], tile.indices[edge.rightSite()]);
+		clipped.setBegin(edge.begin());
+		clipped.setEnd(edge.end());
+		if (clipEdge(clipped, tile.box)) {
+			edges.push_back(clipped);
+		}
+	}
+	writeEdges(output, edges);
+}
@@ -0,0 +1,130 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2015 Lukáš Bednařík l.bednarik@gmail.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef TILING_H
+#define TILING_H
+
+#include "point.h"
+#include "edge.h"
+#include "boundingbox.h"
+#include <vector>
+#include <list>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+
+namespace Voronoi
+{
+	/// Settings of the tiled computation
+	struct TilingOptions
+	{
+		TilingOptions() : Columns(2), Rows(2), Halo(0), Directory("."), Processes(0) {}
+
+		/// Number of tiles along x
+		uint32_t Columns;
+
+		/// Number of tiles along y
+		uint32_t Rows;
+
+		/// Width of the band of neighbouring sites sent with each tile. Zero means automatic.
+		double Halo;
+
+		/// Directory for the tile files. It may be on a filesystem shared by several nodes.
+		///
+		/// The names of the files are unique to the run, several runs may share the directory.
+		std::string Directory;
+
+		/// Command which runs a worker as `<command> <input> <output>`
+		///
+		/// The paths are quoted for the shell. On Windows the directory can't contain `"` or `%`.
+		/// Empty command runs the workers in threads of this process.
+		std::string WorkerCommand;
+
+		/// Maximum number of workers running at once. Zero means the number of cores.
+		unsigned Processes;
+	};
+
+
+	/// Voronoi diagram computed in tiles by separate worker processes
+	///
+	/// The bounding box is split into a grid of tiles. Each tile is written to a file together
+	/// with the sites in a halo around it, a worker computes the diagram of the tile and writes
+	/// the edges clipped to the tile back. Edges cut by the tile seams are joined again.
+	///
+	/// Only the sweeps run in the workers. This process keeps all sites and the merged edges,
+	/// so the input and the diagram must still fit into its memory.
+	class TiledGenerator
+	{
+	public:
+		TiledGenerator(const std::vector<Point> & sites, const BoundingBox & boundingBox = BoundingBox(),
+			const TilingOptions & options = TilingOptions());
+
+		std::list<Edge> getEdges() const;
+
+		/// Return the input sites. Edges refer to them by index.
+		const std::vector<Point> & getSites() const;
+
+		/// Number of edge ends on the tile seams with no counterpart in the neighbouring tile
+		///
+		/// Nonzero value means the halo was too small for the input.
+		size_t seamMismatches() const;
+
+	private:
+		std::vector<Point> _sites;
+		std::list<Edge> _edges;
+		size_t _seamMismatches;
+
+		void _merge(const std::vector<Edge> & pieces, const std::vector<BoundingBox> & tiles,
+			const BoundingBox & boundingBox);
+	};
+
+
+	/// Compute one tile: read the tile file, run the generator and write the clipped edges
+	///
+	/// This is the body of the worker process.
+	void runTileWorker(const std::string & input, const std::string & output);
+}
+
+
+// Implementation
+
+inline std::list<Voronoi::Edge> Voronoi::TiledGenerator::getEdges() const
+{
+	return _edges;
+}
+
+
+inline const std::vector<Voronoi::Point> & Voronoi::TiledGenerator::getSites() const
+{
+	return _sites;
+}
+
+
+inline size_t Voronoi::TiledGenerator::seamMismatches() const
+{
+	return _seamMismatches;
+}
+
+
+#endif  // TILING_H
@@ -1,14 +1,20 @@
 #include "voronoi.h"
 #include "geometry.h"
-#include "make_unique.h"
 #include <algorithm>
 #include <cassert>
+#include <cmath>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
 
 
 namespace
 {
 	const double Epsilon = 1e-12;
 
+	/// Automatic ghost margin in periodic mode as a multiple of the average site distance
+	const double GhostMarginFactor = 3.0;
+
 	/// Return true if Point is zero point
 	bool isZero(const Voronoi::Point & point)
 	{
@@ -16,318 +22,757 @@ namespace
 	}
 
 
-	/// y = f * x + g
-	double coefficientF(const Voronoi::Point & begin, const Voronoi::Point & end)
+	/// Sort a nearly sorted range by insertion
+	///
+	/// Return false after `maxMoves` element moves, the range is a permutation of the input then.
+	template <typename Iterator, typename Compare>
+	bool insertionSort(Iterator first, Iterator last, Compare compare, size_t maxMoves)
 	{
-		return (end.y() - begin.y()) / (end.x() - begin.x());
+		if (first == last) {
+			return true;
+		}
+		for (Iterator it = first + 1; it != last; ++it) {
+			if (!compare(*it, *(it - 1))) {
+				continue;
+			}
+			auto value = *it;
+			Iterator hole = it;
+			do {
+				*hole = *(hole - 1);
+				--hole;
+				if (maxMoves-- == 0) {
+					*hole = value;
+					return false;
+				}
+			} while (hole != first && compare(value, *(hole - 1)));
+			*hole = value;
+		}
+		return true;
+	}
+
+
+	/// Return the point where the ray leaves the bounding box
+	///
+	/// The ray may start outside of the box. The point is null if the ray misses the box.
+	Voronoi::Point rayExit(const Voronoi::Point & origin, const Voronoi::Point & direction,
+		const Voronoi::BoundingBox & boundingBox)
+	{
+		// Liang-Barsky for t in [0, inf)
+		const double p[4] = { -direction.x(), direction.x(), -direction.y(), direction.y() };
+		const double q[4] = { origin.x() - boundingBox.MinX, boundingBox.MaxX - origin.x(),
+			origin.y() - boundingBox.MinY, boundingBox.MaxY - origin.y() };
+		double t0 = 0.0;
+		double t1 = std::numeric_limits<double>::infinity();
+		for (int i = 0; i < 4; ++i) {
+			if (p[i] == 0.0) {
+				if (q[i] < 0.0) {
+					return Voronoi::Point();  // Parallel to the box side and outside
+				}
+			}
+			else if (p[i] < 0.0) {
+				t0 = std::max(t0, q[i] / p[i]);
+			}
+			else {
+				t1 = std::min(t1, q[i] / p[i]);
+			}
+		}
+		if (t0 > t1 || t1 == std::numeric_limits<double>::infinity()) {
+			return Voronoi::Point();
+		}
+		return Voronoi::Point(origin.x() + t1 * direction.x(), origin.y() + t1 * direction.y());
 	}
 
 
-	/// y = f * x + g
-	double coefficientG(const Voronoi::Point & begin, const double f)
+	/// Smallest box of the sites, it may be flat
+	Voronoi::BoundingBox siteExtent(const Voronoi::Point * sites, size_t count)
 	{
-		return begin.y() - f * begin.x();
+		Voronoi::BoundingBox extent;
+		if (count == 0) {
+			return extent;
+		}
+		extent.MinX = extent.MaxX = sites[0].x();
+		extent.MinY = extent.MaxY = sites[0].y();
+		for (size_t i = 1; i < count; ++i) {
+			extent.MinX = std::min(extent.MinX, sites[i].x());
+			extent.MaxX = std::max(extent.MaxX, sites[i].x());
+			extent.MinY = std::min(extent.MinY, sites[i].y());
+			extent.MaxY = std::max(extent.MaxY, sites[i].y());
+		}
+		return extent;
 	}
 }  // end of anonymous namespace
 
 
-Voronoi::BoundingBox::BoundingBox(double minX, double maxX, double minY, double maxY) :
-	MinX(minX), MaxX(maxX), MinY(minY), MaxY(maxY)
+const size_t Voronoi::Generator::CancellationInterval;
+
+
+Voronoi::Generator::Generator(const std::vector<Point> & sites, const BoundingBox & boundingBox, MemoryResource * resource) :
+	Generator(resource)
+{
+	generate(sites, boundingBox);
+}
+
+
+Voronoi::Generator::Generator(MemoryResource * resource) :
+	_edges(resource),
+	_vertexCount(0),
+	_sites(resource),
+	_ghostOrigins(resource),
+	_beachline(_sites, resource),
+	_siteEventQueue(resource),
+	_mergedEvents(resource),
+	_nextSite(0),
+	_isFinished(true),
+	_isUnclipped(false),
+	_unclippedEdges(resource),
+	_edgeGrid(resource),
+	_vertexEventQueue(resource),
+	_cancellationToken(nullptr),
+	_deadline(noDeadline())
 {
-	if (minX >= maxX || minY >= maxY) {
-		throw std::domain_error("Mix/Max coordinates overlat!");
-	}
 }
 
 
-Voronoi::Generator::Generator(const std::vector<Point> & sites, const BoundingBox & boundingBox) :
-	_boundingBox(boundingBox)
+Voronoi::Generator::Generator(Generator && other) :
+	_edges(std::move(other._edges)),
+	_vertexCount(other._vertexCount),
+	_sites(std::move(other._sites)),
+	_ghostOrigins(std::move(other._ghostOrigins)),
+	_beachline(std::move(other._beachline), _sites),
+	_boundingBox(other._boundingBox),
+	_siteEventQueue(std::move(other._siteEventQueue)),
+	_mergedEvents(std::move(other._mergedEvents)),
+	_nextSite(other._nextSite),
+	_inputBox(other._inputBox),
+	_isFinished(other._isFinished),
+	_isUnclipped(other._isUnclipped),
+	_unclippedEdges(std::move(other._unclippedEdges)),
+	_edgeGrid(std::move(other._edgeGrid)),
+	_vertexEventQueue(std::move(other._vertexEventQueue)),
+	_cancellationToken(other._cancellationToken),
+	_deadline(other._deadline)
 {
-	_siteEventQueue.reserve(sites.size());
-	for (const auto & site : sites) {
-		if (site.x() > boundingBox.MinX && site.x() < boundingBox.MaxX && site.y() > boundingBox.MinY && site.y() < boundingBox.MaxY) {
-			_siteEventQueue.emplace_back(site);
+	other._nextSite = 0;
+	other._isFinished = true;
+	other._isUnclipped = false;
+}
+
+
+void Voronoi::Generator::generate(const Point * sites, size_t count, const BoundingBox & boundingBox)
+{
+	start(sites, count, boundingBox);
+	_step(std::numeric_limits<size_t>::max(), noDeadline());
+}
+
+
+void Voronoi::Generator::start(const Point * sites, size_t count, const BoundingBox & boundingBox)
+{
+	_siteEventQueue.clear();
+	_siteEventQueue.reserve(count);
+	for (uint32_t i = 0; i < count; ++i) {
+		if (boundingBox.contains(sites[i])) {
+			_siteEventQueue.emplace_back(i);
 		}
 	}
-	std::sort(_siteEventQueue.begin(), _siteEventQueue.end(), &operator>);
-	_generate();
+	_isUnclipped = false;
+	_startSweep(sites, count, boundingBox, false);
 }
 
 
-void Voronoi::Generator::_generate()
+void Voronoi::Generator::generateUnclipped(const Point * sites, size_t count, const BoundingBox & boundingBox)
 {
-	auto siteIt = _siteEventQueue.begin();
-	while (!_vertexEventQueue.empty() || siteIt != _siteEventQueue.end()) {
-		if (!_vertexEventQueue.empty() && siteIt != _siteEventQueue.end()) {
-			auto vertexEvent = _vertexEventQueue.top().get();
-			if (vertexEvent->site() < siteIt->site()) {
-				_processEvent(&*siteIt);
-				++siteIt;
+	if (boundingBox.Periodic) {
+		throw std::domain_error("Periodic bounding box isn't supported by the unclipped diagram!");
+	}
+	_siteEventQueue.clear();
+	_siteEventQueue.reserve(count);
+	for (uint32_t i = 0; i < count; ++i) {
+		_siteEventQueue.emplace_back(i);
+	}
+	_isUnclipped = true;
+	_startSweep(sites, count, boundingBox, false);
+	_step(std::numeric_limits<size_t>::max(), noDeadline());
+}
 
-			}
-			else {
-				auto event = _vertexEventQueue.top().get();
-				if (!event->isDisabled()) {
-					_processEvent(event);
-				}
-				_vertexEventQueue.pop();
-			}
 
+void Voronoi::Generator::clip(const BoundingBox & boundingBox)
+{
+	if (!_isUnclipped || !_isFinished) {
+		throw std::logic_error("clip: There is no finished unclipped diagram!");
+	}
+	_boundingBox = boundingBox;
+	_inputBox = boundingBox;
+	_edges.clear();
+	_edgeGrid.query(boundingBox, [this, &boundingBox](uint32_t index) {
+		Edge edge = _unclippedEdges[index];
+		if (_finishEdge(edge, boundingBox) && clipEdge(edge, boundingBox) && !isZero(edge.begin() - edge.end())) {
+			_edges.push_back(edge);
 		}
-		else if (!_vertexEventQueue.empty()) {
-			auto event = _vertexEventQueue.top().get();
-			if (!event->isDisabled()) {
-				_processEvent(event);
-			}
-			_vertexEventQueue.pop();
+	});
+}
+
+
+Voronoi::TileEdges Voronoi::Generator::clipTiles(const BoundingBox & boundingBox, uint32_t columns,
+	uint32_t rows, ThreadPool * pool) const
+{
+	if (!_isUnclipped || !_isFinished) {
+		throw std::logic_error("clipTiles: There is no finished unclipped diagram!");
+	}
+
+	// The neighbouring tiles share the same coordinates of their seam
+	auto seam = [](double min, double max, size_t i, size_t count) {
+		return i == count ? max : min + (max - min) * static_cast<double>(i) / static_cast<double>(count);
+	};
+	auto tileBox = [&](size_t tile) {
+		const size_t column = tile % columns;
+		const size_t row = tile / columns;
+		return BoundingBox(seam(boundingBox.MinX, boundingBox.MaxX, column, columns),
+			seam(boundingBox.MinX, boundingBox.MaxX, column + 1, columns),
+			seam(boundingBox.MinY, boundingBox.MaxY, row, rows), seam(boundingBox.MinY, boundingBox.MaxY, row + 1, rows));
+	};
+
+	// The edges near a tile bound the size of its vector, so the tiles don't grow in the pool
+	MemoryResource * resource = _edges.get_allocator().resource();
+	TileEdges tiles(static_cast<size_t>(columns) * rows, EdgeVector(resource), resource);
+	for (size_t tile = 0; tile < tiles.size(); ++tile) {
+		size_t count = 0;
+		_edgeGrid.query(tileBox(tile), [&count](uint32_t) { ++count; });
+		tiles[tile].reserve(count);
+	}
+
+	auto clipRange = [&](size_t begin, size_t end) {
+		for (size_t tile = begin; tile < end; ++tile) {
+			const BoundingBox box = tileBox(tile);
+			_edgeGrid.query(box, [&](uint32_t index) {
+				Edge edge = _unclippedEdges[index];
+				if (_finishEdge(edge, box) && clipEdge(edge, box) && !isZero(edge.begin() - edge.end())) {
+					tiles[tile].push_back(edge);
+				}
+			});
 		}
-		else {  // siteIt != _siteEventQueue.end()
-			_processEvent(&*siteIt);
-			++siteIt;
+	};
+	if (pool) {
+		pool->parallelFor(tiles.size(), clipRange);
+	}
+	else {
+		clipRange(0, tiles.size());
+	}
+	return tiles;
+}
+
+
+void Voronoi::Generator::update(const Point * sites, size_t count)
+{
+	if (!_isFinished || count != _sites.size()) {
+		_regenerate(sites, count);
+		return;
+	}
+
+	// Keep the previous order of the sites still in the box, the ghost sites are added again
+	auto isUsed = [this](const Point & site) {
+		return _isUnclipped || _inputBox.contains(site);
+	};
+	size_t kept = 0;
+	for (const SiteEvent & event : _siteEventQueue) {
+		if (event.site() < count && isUsed(sites[event.site()])) {
+			_siteEventQueue[kept++] = event;
 		}
 	}
-	_postprocessing();
+	_siteEventQueue.erase(_siteEventQueue.begin() + kept, _siteEventQueue.end());
+
+	// A site which entered the box has no place in the previous order
+	if (static_cast<size_t>(std::count_if(sites, sites + count, isUsed)) != kept) {
+		_regenerate(sites, count);
+		return;
+	}
+	_startSweep(sites, count, _inputBox, true);
+	_step(std::numeric_limits<size_t>::max(), noDeadline());
 }
 
 
-std::list<Voronoi::Edge> Voronoi::Generator::getEdges() const
+void Voronoi::Generator::_regenerate(const Point * sites, size_t count)
 {
-	return _edges;
+	if (_isUnclipped) {
+		generateUnclipped(sites, count, _inputBox);
+	}
+	else {
+		generate(sites, count, _inputBox);
+	}
 }
 
 
-// TODO: Musime umet zamenit Min / Max a vetsi/mesi pro přesahy.
-void Help(Voronoi::Edge * edge, const Voronoi::BoundingBox & boundingBox)
+void Voronoi::Generator::_startSweep(const Point * sites, size_t count, const BoundingBox & boundingBox, bool isNearlySorted)
 {
-	if (edge->end().isNull()) {
-
-		const double f = -1.0 / coefficientF(edge->left(), edge->right());
-		const double g = coefficientG(edge->begin(), f);
-
-		if (edge->left().y() == edge->right().y()) {  // f == inf
-			double x = edge->begin().x();
-			double y = boundingBox.MaxY;
-			edge->setEnd(Voronoi::Point(x, y));
-		}
-		else if (f > 0) {
-			// elongate upwards
-			double x = boundingBox.MaxX;
-			double y = f * boundingBox.MaxX + g;
-			if (y > boundingBox.MaxY) {
-				y = boundingBox.MaxY;
-				x = (boundingBox.MaxY - g) / f;
-			}
-			edge->setEnd(Voronoi::Point(x, y));
+	// Clear the previous diagram, the vectors keep their capacity
+	_edges.clear();
+	_vertexCount = 0;
+	_sites.assign(sites, sites + count);
+	_ghostOrigins.clear();
+	_beachline.clear();
+	_boundingBox = _isUnclipped ? siteExtent(sites, count) : boundingBox;
+	_inputBox = boundingBox;
+
+	const size_t siteCount = _siteEventQueue.size();
+	if (boundingBox.Periodic) {
+		_addGhostSites(boundingBox);
+	}
 
+	// About two vertex events per site, spread over the height of the box
+	_vertexEventQueue.reset(_boundingBox.MaxY, _boundingBox.MinY, _siteEventQueue.size());
 
+	// Sort the indices only, the sites stay in the input order
+	const auto & points = _sites;
+	auto compare = [&points](const SiteEvent & left, const SiteEvent & right) {
+		return points[left.site()] > points[right.site()];
+	};
+	if (!isNearlySorted) {
+		std::sort(_siteEventQueue.begin(), _siteEventQueue.end(), compare);
+	}
+	else {
+		// The sites moved a little since the previous diagram, so most of them are still in order.
+		// The ghost sites are sorted on their own and merged in. The insertion sort gives up when
+		// it gets about as expensive as a full sort.
+		auto ghosts = _siteEventQueue.begin() + siteCount;
+		const size_t maxMoves = siteCount * static_cast<size_t>(std::log2(static_cast<double>(siteCount) + 1.0) + 1.0);
+		if (!insertionSort(_siteEventQueue.begin(), ghosts, compare, maxMoves)) {
+			std::sort(_siteEventQueue.begin(), ghosts, compare);
 		}
-		else if (f < 0) {
-			// elongate downwards
-			double x = boundingBox.MaxX;
-			double y = f * boundingBox.MaxX + g;
-			if (y < boundingBox.MinY) {
-				y = boundingBox.MinY;
-				x = (boundingBox.MinY - g) / f;
-			}
-			edge->setEnd(Voronoi::Point(x, y));
-		}
-		else {  // f == 0, left.x == right.x
-			double y = g;
-			double x = boundingBox.MinX;
-			edge->setEnd(Voronoi::Point(x, y));
+		if (ghosts != _siteEventQueue.end()) {
+			std::sort(ghosts, _siteEventQueue.end(), compare);
+			_mergedEvents.clear();
+			std::merge(_siteEventQueue.begin(), ghosts, ghosts, _siteEventQueue.end(), std::back_inserter(_mergedEvents), compare);
+			_siteEventQueue.swap(_mergedEvents);
 		}
+	}
+	_nextSite = 0;
+	_isFinished = false;
+}
 
+
+bool Voronoi::Generator::step(size_t maxEvents)
+{
+	return _step(maxEvents, noDeadline());
+}
+
+
+bool Voronoi::Generator::step(std::chrono::steady_clock::duration budget)
+{
+	return _step(std::numeric_limits<size_t>::max(), std::chrono::steady_clock::now() + budget);
+}
+
+
+void Voronoi::Generator::generate(const Point * sites, size_t count, const BoundingBox & boundingBox,
+	const CancellationToken & token, Deadline deadline)
+{
+	_cancellationToken = &token;
+	_deadline = deadline;
+	try {
+		generate(sites, count, boundingBox);
 	}
+	catch (...) {
+		// The edges of a stopped generation are unfinished
+		_cancellationToken = nullptr;
+		_deadline = noDeadline();
+		_edges.clear();
+		_isFinished = true;
+		throw;
+	}
+	_cancellationToken = nullptr;
+	_deadline = noDeadline();
 }
 
 
-void HelpNeighbour(Voronoi::Edge * edge, const Voronoi::BoundingBox & boundingBox)
+void Voronoi::Generator::_addGhostSites(const BoundingBox & periodicBox)
 {
-	if (edge->end().isNull()) {
-		const double f = -1.0 / coefficientF(edge->left(), edge->right());
-		const double g = coefficientG(edge->begin(), f);
-
-
-		if (edge->left().y() == edge->right().y()) {  // f == inf
-			double x = edge->begin().x();
-			double y = boundingBox.MinY;
-			edge->setEnd(Voronoi::Point(x, y));
-		}
-		else if (f > 0) {
-			// elongate upwards
-			double x = boundingBox.MinX;
-			double y = f * boundingBox.MinX + g;
-			if (y < boundingBox.MinY) {
-				y = boundingBox.MinY;
-				x = (boundingBox.MinY - g) / f;
-			}
-			edge->setEnd(Voronoi::Point(x, y));
-		}
-		else if (f < 0) {
-			// elongate downwards
-			double x = boundingBox.MinX;
-			double y = f * boundingBox.MinX + g;
-			if (y > boundingBox.MaxY) {
-				y = boundingBox.MaxY;
-				x = (boundingBox.MaxY - g) / f;
+	const double width = periodicBox.width();
+	const double height = periodicBox.height();
+
+	// A cell can't reach further than a few average site distances, unless the sites are sparse.
+	double margin = periodicBox.Margin;
+	if (margin <= 0.0) {
+		const double n = static_cast<double>(std::max<size_t>(_siteEventQueue.size(), 1));
+		margin = GhostMarginFactor * std::sqrt(width * height / n);
+	}
+	margin = std::min(margin, std::min(width, height));
+
+	// The sweep runs over the box extended by the margin
+	_boundingBox = BoundingBox(periodicBox.MinX - margin, periodicBox.MaxX + margin,
+		periodicBox.MinY - margin, periodicBox.MaxY + margin);
+
+	// Add ghost copies of the sites within the margin band only
+	const size_t siteCount = _siteEventQueue.size();
+	for (size_t i = 0; i < siteCount; ++i) {
+		const uint32_t site = _siteEventQueue[i].site();
+		for (int dx = -1; dx <= 1; ++dx) {
+			for (int dy = -1; dy <= 1; ++dy) {
+				const Point ghost = _sites[site] + Point(dx * width, dy * height);
+				if ((dx != 0 || dy != 0) && _boundingBox.contains(ghost)) {
+					_siteEventQueue.emplace_back(static_cast<uint32_t>(_sites.size()));
+					_sites.push_back(ghost);
+					_ghostOrigins.push_back(site);
+				}
 			}
-			edge->setEnd(Voronoi::Point(x, y));
-		}
-		else {  // f == 0
-			double y = g;
-			double x = boundingBox.MaxX;
-			edge->setEnd(Voronoi::Point(x, y));
 		}
+	}
+}
+
 
+void Voronoi::Generator::_wrapEdges(const BoundingBox & periodicBox)
+{
+	// Identify the ghost sites with their originals
+	const uint32_t siteCount = static_cast<uint32_t>(_sites.size() - _ghostOrigins.size());
+	auto origin = [this, siteCount](uint32_t site) {
+		return site < siteCount ? site : _ghostOrigins[site - siteCount];
+	};
 
+	_boundingBox = periodicBox;
+	for (auto it = _edges.begin(); it != _edges.end();) {
+		if (!clipEdge(*it, periodicBox)) {
+			it = _edges.erase(it);
+			continue;
+		}
+		Edge wrapped(origin(it->leftSite()), origin(it->rightSite()));
+		wrapped.setBegin(it->begin(), it->beginVertex());
+		wrapped.setEnd(it->end(), it->endVertex());
+		*it = wrapped;
+		++it;
 	}
+
+	// Ghost sites are not needed anymore
+	_sites.resize(siteCount);
+	_ghostOrigins.clear();
 }
 
 
-void Voronoi::Generator::_postprocessing()
+bool Voronoi::Generator::_step(size_t maxEvents, Deadline stepEnd)
 {
-	// Handle site events
-	for (auto it = _edges.begin(); it != _edges.end(); ++it) {
-		if (!it->twin) {  // Site events only
-			continue;
+	if (_isFinished) {
+		return true;
+	}
+
+	// The site events are processed in rows, a row counts as one event
+	const SiteEvent * siteIt = _siteEventQueue.data() + _nextSite;
+	const SiteEvent * siteEnd = _siteEventQueue.data() + _siteEventQueue.size();
+	size_t eventCount = 0;
+	while (!_vertexEventQueue.empty() || siteIt != siteEnd) {
+		if (eventCount == maxEvents) {
+			_nextSite = static_cast<size_t>(siteIt - _siteEventQueue.data());
+			return false;
 		}
+		if (++eventCount % CancellationInterval == 0) {
+			if (_cancellationToken) {
+				_checkCancellation();
+			}
+			if (stepEnd != noDeadline() && std::chrono::steady_clock::now() >= stepEnd) {
+				_nextSite = static_cast<size_t>(siteIt - _siteEventQueue.data());
+				return false;
+			}
+		}
+		if (!_vertexEventQueue.empty() && (siteIt == siteEnd || !(_vertexEventQueue.top()->site() < _sites[siteIt->site()]))) {
+			// Take the event out first, the new events may go on the top
+			auto event = _vertexEventQueue.pop();
+			if (!event->isDisabled()) {
+				_processEvent(event.get());
+			}
+			_vertexEventQueue.release(std::move(event));
+		}
+		else {
+			// All sites with the same "y" at once
+			const double sweepline = _sites[siteIt->site()].y();
+			const SiteEvent * rowEnd = siteIt + 1;
+			while (rowEnd != siteEnd && _sites[rowEnd->site()].y() == sweepline) {
+				++rowEnd;
+			}
+			_processEvents(siteIt, rowEnd);
+			siteIt = rowEnd;
+		}
+	}
+	_nextSite = _siteEventQueue.size();
+	_postprocessing();
+	if (_inputBox.Periodic) {
+		_wrapEdges(_inputBox);
+	}
+	_isFinished = true;
+	return true;
+}
+
 
-		// TODO twin ma definovany jenom 1 edge ze 2. Mohl by to byt i vlastnici pointer.
+void Voronoi::Generator::_checkCancellation() const
+{
+	if (_cancellationToken->isCancelled()) {
+		throw Cancelled("Generation of the Voronoi diagram was cancelled!");
+	}
+	if (_deadline != noDeadline() && std::chrono::steady_clock::now() >= _deadline) {
+		throw DeadlineExceeded("Generation of the Voronoi diagram ran past its deadline!");
+	}
+}
 
-		Help(&*it, _boundingBox);
-		HelpNeighbour(it->twin, _boundingBox);
 
+const Voronoi::EdgeList & Voronoi::Generator::getEdges() const
+{
+	return _edges;
+}
 
 
-		// TODO Vertex eventy - prodloužit a taky jsou tam nějake fake neexistujici.
+const Voronoi::PointVector & Voronoi::Generator::getSites() const
+{
+	return _sites;
+}
 
-		// TODO Asi by stačilo projit jenom vertexy v Beachline a dokončit ji. To by ušetřilo nějaký čas.
 
+Voronoi::Mesh Voronoi::Generator::getMesh() const
+{
+	MemoryResource * resource = _edges.get_allocator().resource();
+	Mesh mesh(resource);
+	mesh.vertices.reserve(2 * _vertexCount);
+	mesh.edges.reserve(2 * _edges.size());
+	mesh.sites.reserve(2 * _edges.size());
+
+	// Vertices are added as they are referenced, so that removed edges leave no unused vertices.
+	// Edge ends which are not vertices (i.e. on the bounding box) are added for every edge.
+	std::vector<uint32_t, Allocator<uint32_t>> meshIndices(_vertexCount, NoVertex, resource);
+	auto addVertex = [&](const Point & point, uint32_t vertex) -> uint32_t {
+		if (vertex != NoVertex && meshIndices[vertex] != NoVertex) {
+			return meshIndices[vertex];
+		}
+		const uint32_t index = static_cast<uint32_t>(mesh.vertices.size() / 2);
+		mesh.vertices.push_back(point.x());
+		mesh.vertices.push_back(point.y());
+		if (vertex != NoVertex) {
+			meshIndices[vertex] = index;
+		}
+		return index;
+	};
 
-		// TODO Spojit site eventy do jednoho edge
-		//twin->setBegin(it->end());
-		//_edges.erase(it--);
+	for (const auto & edge : _edges) {
+		if (edge.begin().isNull() || edge.end().isNull()) {
+			continue;
+		}
+		mesh.edges.push_back(addVertex(edge.begin(), edge.beginVertex()));
+		mesh.edges.push_back(addVertex(edge.end(), edge.endVertex()));
+		mesh.sites.push_back(edge.leftSite());
+		mesh.sites.push_back(edge.rightSite());
 	}
+	return mesh;
+}
 
-	// Remove degenerate vertices
-	for (auto it = _edges.begin(); it != _edges.end(); ++it) {
-		if (isZero(it->begin() - it->end())) {
-			// Vertex event is never first in _edges, so this erase is correct.
-			_edges.erase(it--);
+
+void Voronoi::Generator::_postprocessing()
+{
+	if (_isUnclipped) {
+		// Keep the whole diagram, the output is cut out of it
+		_unclippedEdges.clear();
+		for (const auto & edge : _edges) {
+			if (edge.begin().isNull() || edge.end().isNull() || !isZero(edge.begin() - edge.end())) {
+				_unclippedEdges.push_back(edge);
+			}
 		}
+		// The sweep box is the extent of the sites, where the short edges are
+		_edgeGrid.build(_unclippedEdges.data(), _unclippedEdges.size(), _boundingBox);
+		_isFinished = true;
+		clip(_inputBox);
+		return;
 	}
-	
-	// Remove duplicated edges
+
+	// Finish the edges of breakpoints which are still on the beachline
 	for (auto it = _edges.begin(); it != _edges.end();) {
-		auto first = *it;
-		++it;
-		if (it == _edges.end()) {
-			break;
+		if (_finishEdge(*it, _boundingBox)) {
+			++it;
 		}
-
-		const Point begin = it->begin() - first.begin();
-		const Point end = it->end() - first.end();
-		if (isZero(begin) && isZero(end)) {
-			// Vertex event is never first in _edges, so this erase is correct.
-			_edges.erase(it--);
+		else {
+			it = _edges.erase(it);
 		}
 	}
 
-	
-	/*// Finish edges with no end
-	auto left = _beachline.root();
-	while (!left->isLeaf()) {
-		left = left->leftChild();
+	// Remove degenerate edges
+	for (auto it = _edges.begin(); it != _edges.end();) {
+		if (isZero(it->begin() - it->end())) {
+			it = _edges.erase(it);
+		}
+		else {
+			++it;
+		}
 	}
-	while (left->rightSibling()) {
-		...
+}
+
+
+bool Voronoi::Generator::_finishEdge(Edge & edge, const BoundingBox & boundingBox) const
+{
+	if (!edge.begin().isNull() && !edge.end().isNull()) {
+		return true;
 	}
 
-	// Connect neighbours
-	for (auto it = _edges.begin(); it != _edges.end(); ++it) {
-		auto twin = it->twin;
-		if (twin) {
-			// Connect two twin edges
-			twin->setBegin(it->end());
-			_edges.erase(it--);
+	// The end moves along the direction, the begin moves against it
+	const Point & left = _sites[edge.leftSite()];
+	const Point & right = _sites[edge.rightSite()];
+	const Point direction(right.y() - left.y(), left.x() - right.x());
+	const Point reverse(-direction.x(), -direction.y());
+
+	if (edge.begin().isNull() && edge.end().isNull()) {
+		// Both breakpoints stayed on the beachline, the edge is a whole line. The middle of the sites
+		// may lie outside of the box, then the line crosses the box on one side of it only.
+		const Point middle = (left + right) / 2.0;
+		Point end = rayExit(middle, direction, boundingBox);
+		const Point begin = rayExit(end.isNull() ? middle : end, reverse, boundingBox);
+		if (end.isNull() && !begin.isNull()) {
+			end = rayExit(begin, direction, boundingBox);
 		}
-	}*/
+		if (begin.isNull() || end.isNull()) {
+			return false;
+		}
+		edge.setBegin(begin);
+		edge.setEnd(end);
+	}
+	else if (edge.end().isNull()) {
+		const Point end = rayExit(edge.begin(), direction, boundingBox);
+		if (end.isNull()) {
+			return false;
+		}
+		edge.setEnd(end);
+	}
+	else {
+		const Point begin = rayExit(edge.end(), reverse, boundingBox);
+		if (begin.isNull()) {
+			return false;
+		}
+		edge.setBegin(begin);
+	}
+	return true;
 }
 
 
-void Voronoi::Generator::_circleEvent(ParabolaNode * parabola, const double sweepline)
+void Voronoi::Generator::_circleEvents(Beachline::Index first, Beachline::Index second, const double sweepline)
 {
-	// Find left and right parabola
-	auto left = parabola->leftSibling();
-	auto right = parabola->rightSibling();
-	if (!left || !right || left->site() == right->site()) {
-		return;
+	// Gather the triples with converging breakpoints, so that their circumcenters are computed at once
+	Beachline::Index parabolas[2];
+	Point lefts[2];
+	Point middles[2];
+	Point rights[2];
+	size_t count = 0;
+	for (Beachline::Index parabola : { first, second }) {
+		if (parabola == NullIndex) {
+			continue;
+		}
+
+		// Find left and right parabola
+		auto left = _beachline.leftSibling(parabola);
+		auto right = _beachline.rightSibling(parabola);
+		if (left == NullIndex || right == NullIndex) {
+			continue;
+		}
+
+		// The breakpoints converge only if the sites turn clockwise.
+		// This also rejects collinear sites and the same left and right site.
+		if (orientation(_beachline.focus(left), _beachline.focus(parabola), _beachline.focus(right)) >= 0.0) {
+			continue;
+		}
+		parabolas[count] = parabola;
+		lefts[count] = _beachline.focus(left);
+		middles[count] = _beachline.focus(parabola);
+		rights[count] = _beachline.focus(right);
+		++count;
 	}
 
-	// Check if the bottom point of the circumcircle lies under the sweepline
-	auto center = circumcenter(left->site(), parabola->site(), right->site());
+	Point centers[2];
+	circumcenters(lefts, middles, rights, centers, count);
+	for (size_t i = 0; i < count; ++i) {
+		_circleEvent(parabolas[i], centers[i], sweepline);
+	}
+}
+
+
+void Voronoi::Generator::_circleEvent(Beachline::Index parabola, const Point & center, const double sweepline)
+{
 	if (center.isNull()) {
 		return;
 	}
-	auto radius = circleRadius(center, parabola->site());
-	const double bottomCirclePoint = center.y() - radius;
-	if (bottomCirclePoint <= _boundingBox.MinY) {
-		// Don't generate another event if we are below MinY
+
+	// The bottom point of the circumcircle is `center.y() - radius`. Compare squares first,
+	// so that the square root is computed for accepted events only.
+	const Point & site = _beachline.focus(parabola);
+	const double dx = center.x() - site.x();
+	const double dy = center.y() - site.y();
+	const double radius2 = dx * dx + dy * dy;
+
+	// Don't generate another event if the vertex is below MinY. All sites are processed by then,
+	// so the remaining breakpoints leave the box along their edges. The bottom point of the circle
+	// may lie below MinY while the vertex is still in the box. The unclipped diagram needs all vertices.
+	if (!_isUnclipped && center.y() <= _boundingBox.MinY) {
 		return;
 	}
-	if (bottomCirclePoint > sweepline + Epsilon * sweepline) {
+
+	// Check if the bottom point of the circumcircle lies under the sweepline
+	const double aboveSweepline = center.y() - (sweepline + Epsilon * std::fabs(sweepline));
+	if (aboveSweepline > 0.0 && aboveSweepline * aboveSweepline > radius2) {
 		return;
 	}
 
 	// Create Vertex event
-	auto event = make_unique<VertexEvent>(Point(center.x(), bottomCirclePoint));
+	const double bottomCirclePoint = center.y() - std::sqrt(radius2);
+	auto event = _vertexEventQueue.create(Point(center.x(), bottomCirclePoint));
 	event->setCircumcenter(center);
 	event->setParabolaNode(parabola);
-	parabola->setEvent(event.get());
+	_beachline.setEvent(parabola, event.get());
 	_vertexEventQueue.push(std::move(event));
 }
 
 
-void Voronoi::Generator::_processEvent(const SiteEvent * event)
+void Voronoi::Generator::_processEvents(const SiteEvent * begin, const SiteEvent * end)
 {
-	auto newParabola = _beachline.emplaceParabola(event->site());
-	auto left = newParabola->leftSibling();
-	auto right = newParabola->rightSibling();
-
-	// The `left` is superior to `right`. See note below.
-	if (!left) {
-		return;
-	}
-
-	// For simplicity we suppose the "left" always exists.
-	// This is ensured by our `Compare` functional.
-	assert(!right || left->site() == right->site());
-	const double sweepline = event->site().y();
-
-	// Create a new (dangling) edge
-	Point begin = (left->site() + event->site()) / 2.0;
-	_edges.emplace_back(left->site(), event->site());
-	auto firstEdge = &_edges.back();
-	firstEdge->setBegin(begin);
-
-	_edges.emplace_back(event->site(), left->site());
-	auto secondEdge = &_edges.back();
-	secondEdge->setBegin(begin);
-
-	left->setEdge(firstEdge);
-	newParabola->setEdge(secondEdge);
-	secondEdge->twin = firstEdge;
+	// The sites of a row come from left to right. Only the first one is searched for in the beachline,
+	// each next one lies to the right of the parabola created before.
+	const double sweepline = _sites[begin->site()].y();
+	const bool isTopRow = _beachline.isEmpty();
+	Beachline::Index newParabola = NullIndex;
+	for (const SiteEvent * event = begin; event != end; ++event) {
+		const uint32_t site = event->site();
+		const Point & point = _sites[site];
+		if (_beachline.isEmpty()) {
+			newParabola = _beachline.emplaceParabola(site);
+			continue;
+		}
 
-	/// @TODO twin (co je right napravo) by mohl byt vlastnici pointer, pak ho stejne smazeme...
+		Beachline::Index parabola;
+		if (newParabola == NullIndex) {
+			parabola = _beachline.findParabola(point);
+		}
+		else if (isTopRow) {
+			// The top row parabolas are vertical rays, the rightmost one is the last created
+			parabola = newParabola;
+		}
+		else {
+			// Skip the parabolas left of the site, the new parabolas of this row are behind
+			parabola = _beachline.rightSibling(newParabola);
+			for (auto next = _beachline.rightSibling(parabola); next != NullIndex; next = _beachline.rightSibling(parabola)) {
+				if (parabolaIntersectionX(_beachline.focus(parabola), _beachline.focus(next), sweepline) > point.x()) {
+					break;
+				}
+				parabola = next;
+			}
+		}
+		newParabola = _beachline.emplaceParabola(site, parabola);
+		auto left = _beachline.leftSibling(newParabola);
+		auto right = _beachline.rightSibling(newParabola);
+
+		// For simplicity we suppose the "left" always exists.
+		// This is ensured by our `Compare` functional.
+		assert(left != NullIndex);
+		assert(isTopRow || right == NullIndex || _beachline.site(left) == _beachline.site(right));
+		const uint32_t leftSite = _beachline.site(left);
+
+		// Both new breakpoints trace the same edge in opposite directions.
+		// The breakpoint with the left site on its left finishes the end, the other one the begin.
+		// In the top row the new parabola keeps the breakpoint with its right sibling.
+		_edges.emplace_back(leftSite, site);
+		_beachline.setEdge(left, &_edges.back());
+		if (!isTopRow) {
+			_beachline.setEdge(newParabola, &_edges.back());
+		}
 
-	// Check fircle event
-	if (left) {
-		_circleEvent(left, sweepline);
-	}
-	if (right) {		
+		// Check fircle event
 		// The event can sometimes be at the same position as previous "left",
 		// but this "right" belongs to another ("right") parabola.
-		_circleEvent(right, sweepline);  // s right je to spravne!
+		_circleEvents(left, right, sweepline);  // s right je to spravne!
 	}
 }
 
@@ -338,28 +783,38 @@ void Voronoi::Generator::_processEvent(VertexEvent * event)
 	const double sweepline = event->site().y();
 
 	// Left and right always exists in vertex event
-	auto left = event->parabolaNode()->leftSibling();
-	auto right = event->parabolaNode()->rightSibling();
+	const auto parabola = event->parabolaNode();
+	auto left = _beachline.leftSibling(parabola);
+	auto right = _beachline.rightSibling(parabola);
 
-	// Finish two edges
-	if (left->site().x() < event->site().x()) {
-		left->edge()->setEnd(event->circumcenter());  // nastavujeme konec pro prave pokracovani
-	}
+	// New vertex of the diagram
+	const Point vertex = event->circumcenter();
+	const uint32_t vertexIndex = _vertexCount++;
 
-	if (event->site().x() < right->site().x()) {  // TODO `<=` or `<` ?
-		event->parabolaNode()->edge()->setEnd(event->circumcenter());  // nastavujeme konec pro leve pokracovani
-	}
+	// Finish the edges of both breakpoints
+	_finishBreakpoint(left, vertex, vertexIndex);
+	_finishBreakpoint(parabola, vertex, vertexIndex);
 	
 	// Remove this parabola (this also disables events with this parabola's site]
-	_beachline.removeParabola(event->parabolaNode());
-	assert(left->site() != right->site()); // left and right parabolas can't have the same focus
+	_beachline.removeParabola(parabola);
+	assert(_beachline.site(left) != _beachline.site(right)); // left and right parabolas can't have the same focus
 
 	// Create a new (dangling) edge
-	_edges.emplace_back(left->site(), right->site());
-	left->setEdge(&_edges.back());
-	left->edge()->setBegin(event->circumcenter());
+	_edges.emplace_back(_beachline.site(left), _beachline.site(right));
+	_beachline.setEdge(left, &_edges.back());
+	_beachline.edge(left)->setBegin(vertex, vertexIndex);
 
-	_circleEvent(left, sweepline);
-	_circleEvent(right, sweepline);
+	_circleEvents(left, right, sweepline);
 }
 
+
+void Voronoi::Generator::_finishBreakpoint(Beachline::Index parabola, const Point & vertex, uint32_t vertexIndex)
+{
+	Edge * edge = _beachline.edge(parabola);
+	if (_beachline.site(parabola) == edge->leftSite()) {
+		edge->setEnd(vertex, vertexIndex);
+	}
+	else {
+		edge->setBegin(vertex, vertexIndex);
+	}
+}
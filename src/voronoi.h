@@ -24,65 +24,251 @@
 #ifndef VORONOI_H
 #define VORONOI_H
 
+#include "boundingbox.h"
 #include "edge.h"
 #include "event.h"
+#include "eventqueue.h"
 #include "beachline.h"
+#include "mesh.h"
+#include "memoryresource.h"
+#include "cancellation.h"
+#include "edgegrid.h"
+#include "threadpool.h"
 #include <vector>
 #include <list>
-#include <queue>
+#include <chrono>
 
 
 namespace Voronoi
 {
-	struct BoundingBox
-	{
-		BoundingBox() : MinX(0), MaxX(1), MinY(0), MaxY(1) {}
-		BoundingBox(double minX, double maxX, double minY, double maxY);
-		double MinX;
-		double MaxX;
-		double MinY;
-		double MaxY;
-	};
+	/// Edges of a diagram, the memory comes from the resource of the generator
+	typedef std::list<Edge, Allocator<Edge>> EdgeList;
+	typedef std::vector<Edge, Allocator<Edge>> EdgeVector;
+	typedef std::vector<EdgeVector, Allocator<EdgeVector>> TileEdges;
 
 
 	class Generator
 	{
 	public:
 		/// Calculate Voronoi diagram
-		Generator(const std::vector<Point> & sites, const BoundingBox & boundingBox = BoundingBox());
+		///
+		/// If the bounding box is periodic, only the sites close to the box edges are
+		/// replicated and the resulting edges are clipped to the box. Sites of the edges
+		/// are wrapped into the box, so an edge cut by the boundary continues on the
+		/// opposite side with the same pair of sites.
+		///
+		/// All memory of the generator and of its output comes from the resource, e.g.
+		/// a `MonotonicBuffer` of a request. The resource must outlive the generator.
+		Generator(const std::vector<Point> & sites, const BoundingBox & boundingBox = BoundingBox(),
+			MemoryResource * resource = newDeleteResource());
+
+		/// Empty diagram, call `generate` to compute one
+		explicit Generator(MemoryResource * resource = newDeleteResource());
+
+		/// Take the diagram and the buffers of the other generator, which is left empty
+		///
+		/// The beachline refers to the sites of the generator, so it is rebound to the moved ones.
+		Generator(Generator && other);
+
+		Generator(const Generator &) = delete;
+		Generator & operator=(const Generator &) = delete;
+		Generator & operator=(Generator &&) = delete;
+
+		/// Calculate a new Voronoi diagram, the buffers of the previous one are reused
+		void generate(const Point * sites, size_t count, const BoundingBox & boundingBox = BoundingBox());
+		void generate(const std::vector<Point> & sites, const BoundingBox & boundingBox = BoundingBox());
+
+		/// Calculate a new Voronoi diagram unless the token is cancelled or the deadline passes
+		///
+		/// Both are checked every `CancellationInterval` events. A stopped generation throws
+		/// `Cancelled` or `DeadlineExceeded` and leaves no edges.
+		void generate(const Point * sites, size_t count, const BoundingBox & boundingBox,
+			const CancellationToken & token, Deadline deadline = noDeadline());
+
+		/// Number of events between two checks of the cancellation token and the deadline
+		static const size_t CancellationInterval = 256;
+
+		/// Calculate the whole Voronoi diagram of all sites, the box clips the output only
+		///
+		/// The sites outside of the box take part too and the unclipped diagram is kept,
+		/// so that `clip` can cut it to another box without a new sweep. Periodic box isn't supported.
+		void generateUnclipped(const Point * sites, size_t count, const BoundingBox & boundingBox = BoundingBox());
+		void generateUnclipped(const std::vector<Point> & sites, const BoundingBox & boundingBox = BoundingBox());
+
+		/// Cut the unclipped diagram to another box, `getEdges` returns the result
+		///
+		/// The edges are binned in a grid, so only the ones near the box are visited.
+		void clip(const BoundingBox & boundingBox);
+
+		/// Cut the unclipped diagram to a grid of `columns` x `rows` tiles over the box
+		///
+		/// Tile [column, row] has index `row * columns + column`, row 0 at the bottom of the box.
+		/// Each tile is clipped like by `clip` and the tiles are processed in the pool, the
+		/// diagram itself doesn't change. The tiles are allocated from the resource of the generator
+		/// by the calling thread, so the resource needn't be thread safe.
+		TileEdges clipTiles(const BoundingBox & boundingBox, uint32_t columns, uint32_t rows,
+			ThreadPool * pool = nullptr) const;
+
+		/// Return the whole diagram calculated by `generateUnclipped`
+		///
+		/// Edges going to infinity have a null end. A missing end lies in the direction of
+		/// `right - left` site turned clockwise, a missing begin in the opposite direction.
+		const EdgeVector & getUnclippedEdges() const;
+
+		/// Calculate the diagram of the same sites moved a little since the previous one
+		///
+		/// The box of the previous diagram is used. The sites are sorted starting from the previous
+		/// order, which takes about linear time if they keep their vertical order mostly. Changed
+		/// site count or sites entering the box fall back to `generate`.
+		void update(const Point * sites, size_t count);
+		void update(const std::vector<Point> & sites);
+
+		/// Prepare a new Voronoi diagram to be calculated by `step` in slices
+		///
+		/// The sites are copied, the caller doesn't have to keep them.
+		void start(const Point * sites, size_t count, const BoundingBox & boundingBox = BoundingBox());
+		void start(const std::vector<Point> & sites, const BoundingBox & boundingBox = BoundingBox());
+
+		/// Continue the sweep by `maxEvents` events at most, return true once the diagram is finished
+		///
+		/// The beachline and the queues are kept between the calls. The edges are incomplete
+		/// until the last step, which also finishes the edges going out of the box.
+		bool step(size_t maxEvents);
+
+		/// Continue the sweep for about `budget`, return true once the diagram is finished
+		///
+		/// The clock is read every `CancellationInterval` events, so a step may run a little longer.
+		bool step(std::chrono::steady_clock::duration budget);
+
+		/// True when the last diagram is finished
+		bool isFinished() const;
 
 		/// Return all edges of Voronoi diagram
-		std::list<Edge> getEdges() const;
+		const EdgeList & getEdges() const;
+
+		/// Return the input sites. Edges refer to them by index.
+		const PointVector & getSites() const;
+
+		/// Return the diagram as a vertex array and an edge index array
+		///
+		/// Every vertex is stored once. Edges with an unfinished end are left out. The mesh is
+		/// built from the edges after the sweep; the vertex events only number the vertices, so
+		/// no points are hashed, but the mesh is a copy next to the edges and saves no memory.
+		Mesh getMesh() const;
+
+		/// Vertex events of the last sweep, how many were disabled and how many reused the memory of another one
+		const EventStatistics & getEventStatistics() const;
 
 		
 		// TODO get edges for one site function
 		// TODO get next site in direction
-		// TODO use std::reference_wrapper and compute with references... not to duplicate or round points
 
 
 	private:
 		/// List of all found edges
-		std::list<Edge> _edges;
+		EdgeList _edges;
+
+		/// Number of the vertices found by the vertex events, the edges keep their indices
+		uint32_t _vertexCount;
+
+		/// Input sites followed by ghost sites. Events, beachline and edges refer to them by index.
+		PointVector _sites;
 
-		/// Beachline or also "borderline". This is root of beachline tree.
-		ParabolaNode _beachline;
+		/// Original site for each ghost site in periodic mode
+		std::vector<uint32_t, Allocator<uint32_t>> _ghostOrigins;
+
+		/// Beachline or also "borderline".
+		Beachline _beachline;
 
 		/// Bounding box is input paramter
 		BoundingBox _boundingBox;
 
+		/// Queue of site events, sorted once
+		std::vector<SiteEvent, Allocator<SiteEvent>> _siteEventQueue;
+
+		/// Site events merged with the ghost site events by `update`, swapped with the queue
+		std::vector<SiteEvent, Allocator<SiteEvent>> _mergedEvents;
+
+		/// Index of the next site event to process
+		size_t _nextSite;
+
+		/// Bounding box given by the caller, the sweep may run over a larger one.
+		/// The edges of a periodic diagram are wrapped into it at the end of the sweep.
+		BoundingBox _inputBox;
+
+		bool _isFinished;
+
+		/// The diagram of `generateUnclipped` and its grid for `clip`
+		bool _isUnclipped;
+		EdgeVector _unclippedEdges;
+		EdgeGrid _edgeGrid;
+
 		/// Take high priority (big "y" coordinate) events first
-		std::priority_queue<std::unique_ptr<VertexEvent>, std::vector<std::unique_ptr<VertexEvent>>> _vertexEventQueue;
+		VertexEventQueue _vertexEventQueue;
 
-		/// Queue of site events
-		std::vector<SiteEvent> _siteEventQueue;
+		/// Token of the running generation, null if it can't be stopped
+		const CancellationToken * _cancellationToken;
+		Deadline _deadline;
 
-		void _generate();
+		void _regenerate(const Point * sites, size_t count);
+		void _startSweep(const Point * sites, size_t count, const BoundingBox & boundingBox, bool isNearlySorted);
+		bool _step(size_t maxEvents, Deadline stepEnd);
+		void _checkCancellation() const;
 		void _postprocessing();
-		void _processEvent(const SiteEvent * event);
+		bool _finishEdge(Edge & edge, const BoundingBox & boundingBox) const;
+		void _addGhostSites(const BoundingBox & periodicBox);
+		void _wrapEdges(const BoundingBox & periodicBox);
+		void _processEvents(const SiteEvent * begin, const SiteEvent * end);
 		void _processEvent(VertexEvent * event);
-		void _circleEvent(ParabolaNode * parabola, const double sweepline);
+		void _finishBreakpoint(Beachline::Index parabola, const Point & vertex, uint32_t vertexIndex);
+		void _circleEvents(Beachline::Index first, Beachline::Index second, const double sweepline);
+		void _circleEvent(Beachline::Index parabola, const Point & center, const double sweepline);
 	};
 }
 
 
+// Implementation
+
+inline void Voronoi::Generator::generate(const std::vector<Point> & sites, const BoundingBox & boundingBox)
+{
+	generate(sites.data(), sites.size(), boundingBox);
+}
+
+
+inline void Voronoi::Generator::generateUnclipped(const std::vector<Point> & sites, const BoundingBox & boundingBox)
+{
+	generateUnclipped(sites.data(), sites.size(), boundingBox);
+}
+
+
+inline const Voronoi::EdgeVector & Voronoi::Generator::getUnclippedEdges() const
+{
+	return _unclippedEdges;
+}
+
+
+inline const Voronoi::EventStatistics & Voronoi::Generator::getEventStatistics() const
+{
+	return _vertexEventQueue.statistics();
+}
+
+
+inline void Voronoi::Generator::update(const std::vector<Point> & sites)
+{
+	update(sites.data(), sites.size());
+}
+
+
+inline void Voronoi::Generator::start(const std::vector<Point> & sites, const BoundingBox & boundingBox)
+{
+	start(sites.data(), sites.size(), boundingBox);
+}
+
+
+inline bool Voronoi::Generator::isFinished() const
+{
+	return _isFinished;
+}
+
+
 #endif  // VORONOI_H
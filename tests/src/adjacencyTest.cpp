@@ -0,0 +1,174 @@
+#include "tests.h"
+#include "adjacency.h"
+#include <algorithm>
+#include <cmath>
+#include <set>
+#include <stdexcept>
+
+
+namespace
+{
+	/// Sites at most `k` hops away by a search over the edges
+	std::set<uint32_t> reachable(const Voronoi::EdgeList & edges, uint32_t site, unsigned k)
+	{
+		std::set<uint32_t> found = { site };
+		for (unsigned hop = 0; hop < k; ++hop) {
+			std::set<uint32_t> next = found;
+			for (const auto & edge : edges) {
+				if (found.count(edge.leftSite())) {
+					next.insert(edge.rightSite());
+				}
+				if (found.count(edge.rightSite())) {
+					next.insert(edge.leftSite());
+				}
+			}
+			found = next;
+		}
+		return found;
+	}
+}
+
+
+SUITE(AdjacencyTest)
+{
+	TEST(Graph_SameAsEdges)
+	{
+		const auto sites = randomSites(500, 1);
+		const Voronoi::Generator generator(sites);
+		const Voronoi::AdjacencyGraph graph(generator.getEdges(), sites.size());
+		CHECK_EQUAL(sites.size(), graph.siteCount());
+		CHECK_EQUAL(2 * generator.getEdges().size(), graph.neighbours().size());
+		for (const auto & edge : generator.getEdges()) {
+			CHECK(std::binary_search(graph.neighboursBegin(edge.leftSite()), graph.neighboursEnd(edge.leftSite()), edge.rightSite()));
+			CHECK(std::binary_search(graph.neighboursBegin(edge.rightSite()), graph.neighboursEnd(edge.rightSite()), edge.leftSite()));
+		}
+	}
+
+
+	TEST(Graph_PeriodicDuplicatesDropped)
+	{
+		const auto sites = randomSites(100, 2);
+		Voronoi::BoundingBox box;
+		box.Periodic = true;
+		const Voronoi::Generator generator(sites, box);
+		Voronoi::ThreadPool pool(4);
+		const Voronoi::AdjacencyGraph graph(generator.getEdges(), sites.size(), &pool);
+		std::set<std::pair<uint32_t, uint32_t>> pairs;
+		for (const auto & edge : generator.getEdges()) {
+			pairs.emplace(std::min(edge.leftSite(), edge.rightSite()), std::max(edge.leftSite(), edge.rightSite()));
+		}
+		CHECK_EQUAL(2 * pairs.size(), graph.neighbours().size());
+		for (uint32_t site = 0; site < sites.size(); ++site) {
+			CHECK(std::adjacent_find(graph.neighboursBegin(site), graph.neighboursEnd(site)) == graph.neighboursEnd(site));
+		}
+		CHECK_THROW(Voronoi::AdjacencyGraph(generator.getEdges(), 10), std::out_of_range);
+	}
+
+
+	TEST(KRing_SameAsSearch)
+	{
+		const auto sites = randomSites(400, 3);
+		const Voronoi::Generator generator(sites);
+		const Voronoi::AdjacencyGraph graph(generator.getEdges(), sites.size());
+		for (uint32_t site : { 0u, 17u, 399u }) {
+			for (unsigned k : { 0u, 1u, 3u }) {
+				const auto ring = graph.kRing(site, k);
+				CHECK_EQUAL(site, ring.front());
+				const auto expected = reachable(generator.getEdges(), site, k);
+				CHECK(std::set<uint32_t>(ring.begin(), ring.end()) == expected);
+				CHECK_EQUAL(expected.size(), ring.size());
+			}
+		}
+		CHECK_EQUAL(size_t(1) + (graph.neighboursEnd(5) - graph.neighboursBegin(5)), graph.kRing(5, 1).size());
+	}
+
+
+	TEST(KRings_SameInPool)
+	{
+		const auto sites = randomSites(1000, 4);
+		const Voronoi::Generator generator(sites);
+		const Voronoi::AdjacencyGraph graph(generator.getEdges(), sites.size());
+		std::vector<uint32_t> queries;
+		for (uint32_t site = 0; site < sites.size(); site += 7) {
+			queries.push_back(site);
+		}
+		Voronoi::ThreadPool pool(4);
+		const auto rings = graph.kRings(queries, 2, &pool);
+		CHECK_EQUAL(queries.size(), rings.size());
+		for (size_t i = 0; i < queries.size(); ++i) {
+			CHECK(rings[i] == graph.kRing(queries[i], 2));
+		}
+	}
+
+
+	TEST(MinimumSpanningTree_SameAsPrim)
+	{
+		const auto sites = randomSites(300, 5);
+		const Voronoi::Generator generator(sites);
+		const Voronoi::AdjacencyGraph graph(generator.getEdges(), sites.size());
+		Voronoi::ThreadPool pool(4);
+		const auto tree = graph.minimumSpanningTree(sites.data(), &pool);
+		CHECK_EQUAL(sites.size() - 1, tree.size());
+		CHECK(tree == graph.minimumSpanningTree(sites.data()));
+
+		// Prim's algorithm over all pairs of the sites
+		auto distance = [&sites](size_t a, size_t b) {
+			const double dx = sites[a].x() - sites[b].x();
+			const double dy = sites[a].y() - sites[b].y();
+			return std::sqrt(dx * dx + dy * dy);
+		};
+		std::vector<bool> isInTree(sites.size(), false);
+		std::vector<double> nearest(sites.size(), 1e9);
+		nearest[0] = 0.0;
+		double expectedLength = 0.0;
+		for (size_t step = 0; step < sites.size(); ++step) {
+			size_t next = sites.size();
+			for (size_t i = 0; i < sites.size(); ++i) {
+				if (!isInTree[i] && (next == sites.size() || nearest[i] < nearest[next])) {
+					next = i;
+				}
+			}
+			isInTree[next] = true;
+			expectedLength += nearest[next];
+			for (size_t i = 0; i < sites.size(); ++i) {
+				nearest[i] = std::min(nearest[i], distance(next, i));
+			}
+		}
+		double length = 0.0;
+		for (const auto & edge : tree) {
+			CHECK(edge.first < edge.second);
+			length += distance(edge.first, edge.second);
+		}
+		CHECK_CLOSE(expectedLength, length, 1e-9);
+	}
+
+
+	TEST(NearestNeighbours_SameAsBruteForce)
+	{
+		const auto sites = randomSites(500, 6);
+		const Voronoi::Generator generator(sites);
+		const Voronoi::AdjacencyGraph graph(generator.getEdges(), sites.size());
+		Voronoi::ThreadPool pool(4);
+		const auto nearest = graph.nearestNeighbours(sites.data(), &pool);
+		for (size_t site = 0; site < sites.size(); ++site) {
+			size_t expected = site;
+			double expectedDistance = 0.0;
+			for (size_t other = 0; other < sites.size(); ++other) {
+				const double dx = sites[site].x() - sites[other].x();
+				const double dy = sites[site].y() - sites[other].y();
+				if (other != site && (expected == site || dx * dx + dy * dy < expectedDistance)) {
+					expected = other;
+					expectedDistance = dx * dx + dy * dy;
+				}
+			}
+			CHECK_EQUAL(expected, nearest[site]);
+		}
+
+		// A site out of the box has no cell
+		auto withOutside = sites;
+		withOutside.emplace_back(2.0, 2.0);
+		const Voronoi::Generator clipped(withOutside);
+		const Voronoi::AdjacencyGraph clippedGraph(clipped.getEdges(), withOutside.size());
+		CHECK_EQUAL(Voronoi::NoSite, clippedGraph.nearestNeighbours(withOutside.data()).back());
+	}
+}
@@ -0,0 +1,77 @@
+#include "tests.h"
+#include "async.h"
+#include <chrono>
+#include <future>
+
+
+SUITE(AsyncTest)
+{
+	TEST(Async_SameAsSync)
+	{
+		const auto sites = randomSites(2000, 1);
+		Voronoi::ThreadPool pool(2);
+		auto future = Voronoi::generateAsync(Voronoi::poolExecutor(pool), sites);
+		const auto generator = future.get();
+		const Voronoi::Generator expected(sites);
+		CHECK_EQUAL(expected.getEdges().size(), generator->getEdges().size());
+		CHECK_EQUAL(sites.size(), generator->getSites().size());
+	}
+
+
+	TEST(Async_ReturnsBeforeFinished)
+	{
+		// The only thread of the pool waits for the release, so the generation can't have run yet
+		Voronoi::ThreadPool pool(1);
+		std::promise<void> release;
+		std::shared_future<void> released = release.get_future().share();
+		pool.post([released]() { released.wait_for(std::chrono::seconds(10)); });
+		auto future = Voronoi::generateAsync(Voronoi::poolExecutor(pool), randomSites(100, 5));
+		CHECK(future.wait_for(std::chrono::seconds(0)) == std::future_status::timeout);
+		release.set_value();
+		CHECK_EQUAL(Voronoi::Generator(randomSites(100, 5)).getEdges().size(), future.get()->getEdges().size());
+	}
+
+
+	TEST(Async_CancelledBeforeStart)
+	{
+		// The executor holds the task until the token is cancelled
+		std::vector<std::function<void()>> tasks;
+		Voronoi::Executor executor = [&tasks](std::function<void()> task) { tasks.push_back(task); };
+		Voronoi::CancellationToken token;
+		auto future = Voronoi::generateAsync(executor, randomSites(100, 2), Voronoi::BoundingBox(), token);
+		token.cancel();
+		tasks.front()();
+		CHECK_THROW(future.get(), Voronoi::Cancelled);
+	}
+
+
+	TEST(Generate_CancelledLeavesNoEdges)
+	{
+		const auto sites = randomSites(4 * Voronoi::Generator::CancellationInterval, 3);
+		Voronoi::Generator generator;
+		Voronoi::CancellationToken token;
+		token.cancel();
+		CHECK_THROW(generator.generate(sites.data(), sites.size(), Voronoi::BoundingBox(), token), Voronoi::Cancelled);
+		CHECK(generator.getEdges().empty());
+
+		// The generator is usable after the stop and doesn't check the old token
+		generator.generate(sites);
+		CHECK_EQUAL(Voronoi::Generator(sites).getEdges().size(), generator.getEdges().size());
+	}
+
+
+	TEST(Generate_DeadlinePassed)
+	{
+		const auto sites = randomSites(4 * Voronoi::Generator::CancellationInterval, 4);
+		Voronoi::Generator generator;
+		const auto deadline = std::chrono::steady_clock::now() - std::chrono::seconds(1);
+		CHECK_THROW(generator.generate(sites.data(), sites.size(), Voronoi::BoundingBox(), Voronoi::CancellationToken(), deadline),
+			Voronoi::DeadlineExceeded);
+		CHECK(generator.getEdges().empty());
+
+		// Far deadline doesn't stop anything
+		const auto later = std::chrono::steady_clock::now() + std::chrono::hours(1);
+		generator.generate(sites.data(), sites.size(), Voronoi::BoundingBox(), Voronoi::CancellationToken(), later);
+		CHECK(!generator.getEdges().empty());
+	}
+}
@@ -0,0 +1,54 @@
+#include "tests.h"
+#include "batch.h"
+#include "engine.h"
+#include "voronoi.h"
+
+
+SUITE(BatchTest)
+{
+	TEST(Generator_Reused)
+	{
+		const auto first = randomSites(300, 1);
+		const auto second = randomSites(200, 2);
+		Voronoi::Generator generator;
+		generator.generate(first);
+		generator.generate(second);
+		const Voronoi::Generator fresh(second);
+		CHECK(sitePairs(generator.getEdges()) == sitePairs(fresh.getEdges()));
+		CHECK_EQUAL(fresh.getEdges().size(), generator.getEdges().size());
+	}
+
+
+	TEST(Batch_SameAsSingle)
+	{
+		// Small and large diagrams mixed, so the threads finish at different times
+		std::vector<std::vector<Voronoi::Point>> sites;
+		std::vector<Voronoi::BatchJob> jobs;
+		for (unsigned i = 0; i < 40; ++i) {
+			sites.push_back(randomSites(i % 5 == 0 ? 500 : 10 + i, i));
+		}
+		for (const auto & jobSites : sites) {
+			jobs.emplace_back(jobSites.data(), jobSites.size());
+		}
+
+		Voronoi::ThreadPool pool(4);
+		Voronoi::BatchGenerator batch(pool);
+		std::vector<std::vector<Voronoi::Edge>> results(jobs.size());
+		for (int round = 0; round < 2; ++round) {
+			batch.generate(jobs.data(), jobs.size(), results.data());
+			for (size_t i = 0; i < jobs.size(); ++i) {
+				std::vector<Voronoi::Edge> single;
+				Voronoi::generateEdges(sites[i], single, Voronoi::BoundingBox(), Voronoi::Engine::Fortune);
+				CHECK(sitePairs(results[i]) == sitePairs(single));
+			}
+		}
+	}
+
+
+	TEST(Batch_Empty)
+	{
+		Voronoi::ThreadPool pool(2);
+		Voronoi::BatchGenerator batch(pool);
+		batch.generate(nullptr, 0, nullptr);
+	}
+}
@@ -5,60 +5,102 @@ using namespace Voronoi;
 
 SUITE(BeachlineTest)
 {
-	TEST(Parabola_NoSite_IsInvalid)
+	TEST(Beachline_NoSite_IsEmpty)
 	{
-		Parabola parabola;
-		CHECK(!parabola.isValid());
+		PointVector sites;
+		Beachline beachline(sites);
+		CHECK(beachline.isEmpty());
 	}
 
 
-	TEST(Parabola_SiteConstructor_IsValid)
+	TEST(Beachline_EmplaceParabola_ReturnsRoot)
 	{
-		Parabola parabola(Point(0,0));
-		CHECK(parabola.isValid());
+		PointVector sites;
+		sites.emplace_back(0, 0);
+		Beachline beachline(sites);
+		auto newParabola = beachline.emplaceParabola(0);
+		CHECK(!beachline.isEmpty());
+		CHECK_EQUAL(beachline.root(), newParabola);
+		CHECK(beachline.parent(newParabola) == NullIndex);
+		CHECK(beachline.isLeaf(newParabola));
+		CHECK_EQUAL(0u, beachline.site(newParabola));
 	}
 
 
-	TEST(Parabola_SiteInvalid_IsInvalid)
+	TEST(Beachline_Emplace2Parabolas_NewParabolaIsPresent)
 	{
-		Point p;
-		Parabola parabola(p);
-		CHECK(!parabola.isValid());
+		PointVector sites;
+		sites.emplace_back(1, 1);
+		sites.emplace_back(0, 0);
+		Beachline beachline(sites);
+		auto first = beachline.emplaceParabola(0);
+		auto second = beachline.emplaceParabola(1);
+
+		// The first parabola is split into two around the second one
+		CHECK(!beachline.isLeaf(first));
+		CHECK(beachline.isLeaf(second));
+		CHECK_EQUAL(1u, beachline.site(second));
+		auto left = beachline.leftSibling(second);
+		auto right = beachline.rightSibling(second);
+		CHECK(left != NullIndex && right != NullIndex);
+		CHECK_EQUAL(0u, beachline.site(left));
+		CHECK_EQUAL(0u, beachline.site(right));
+		CHECK(beachline.leftSibling(left) == NullIndex);
+		CHECK(beachline.rightSibling(right) == NullIndex);
 	}
 
 
-	TEST(Parabola_SiteSet_IsValid)
-	{
-		Parabola parabola;
-		parabola.setSite(Point(0, 0));
-		CHECK(parabola.isValid());
-	}
-
 
-	TEST(ParabolaNode_Empty_NoParrent)
+	TEST(Beachline_EmplaceRow_ParabolasSideBySide)
 	{
-		ParabolaNode root;
-		CHECK(!root.parent());
+		PointVector sites;
+		sites.emplace_back(0.2, 0.5);
+		sites.emplace_back(0.5, 0.5);
+		sites.emplace_back(0.8, 0.5);
+		Beachline beachline(sites);
+		auto first = beachline.emplaceParabola(0);
+		auto second = beachline.emplaceParabola(1, first);
+		auto third = beachline.emplaceParabola(2, second);
+
+		// Sites on the sweepline don't split the parabola, they are placed next to it
+		auto middle = beachline.leftSibling(third);
+		auto left = beachline.leftSibling(middle);
+		CHECK_EQUAL(2u, beachline.site(third));
+		CHECK_EQUAL(1u, beachline.site(middle));
+		CHECK_EQUAL(0u, beachline.site(left));
+		CHECK(beachline.leftSibling(left) == NullIndex);
+		CHECK(beachline.rightSibling(third) == NullIndex);
 	}
 
-
-	TEST(ParabolaNode_EmplaceParabola_ReturnsRoot)
+	TEST(Beachline_FindParabola_ReturnsParabolaUnderPoint)
 	{
-		ParabolaNode root;
-		auto newParabola = root.emplaceParabola(Point(0, 0));
-		CHECK(!root.parent());
-		CHECK(newParabola = &root);
+		PointVector sites;
+		sites.emplace_back(0.5, 1);
+		sites.emplace_back(0.5, 0.5);
+		Beachline beachline(sites);
+		beachline.emplaceParabola(0);
+		auto second = beachline.emplaceParabola(1);
+		CHECK_EQUAL(second, beachline.findParabola(Point(0.5, 0.4)));
+		CHECK_EQUAL(beachline.leftSibling(second), beachline.findParabola(Point(-2, 0.4)));
+		CHECK_EQUAL(beachline.rightSibling(second), beachline.findParabola(Point(3, 0.4)));
 	}
 
 
-	TEST(ParabolaNode_Emplace2Parabolas_NewParabolaIsPresent)
+	TEST(Beachline_RemoveParabola_SiblingsConnected)
 	{
-		ParabolaNode root;
-		auto first = root.emplaceParabola(Point(1, 1));
-		auto second = root.emplaceParabola(Point(0, 0));
-		CHECK(first == second->parent());
-		//CHECK(&root == first->parent());
-		//CHECK(&root == second->parent());
+		PointVector sites;
+		sites.emplace_back(0.5, 1);
+		sites.emplace_back(0.5, 0.5);
+		Beachline beachline(sites);
+		beachline.emplaceParabola(0);
+		auto second = beachline.emplaceParabola(1);
+		auto left = beachline.leftSibling(second);
+		auto right = beachline.rightSibling(second);
+		beachline.removeParabola(second);
+
+		CHECK_EQUAL(right, beachline.rightSibling(left));
+		CHECK_EQUAL(left, beachline.leftSibling(right));
+		CHECK_EQUAL(beachline.root(), beachline.parent(left));
+		CHECK_EQUAL(beachline.root(), beachline.parent(right));
 	}
-
 }
@@ -0,0 +1,144 @@
+#include "tests.h"
+#include "delaunay.h"
+#include "engine.h"
+#include "geometry.h"
+#include <cmath>
+
+
+SUITE(DelaunayTest)
+{
+	TEST(FourSites_TwoTriangles)
+	{
+		std::vector<Voronoi::Point> sites;
+		sites.emplace_back(0.2, 0.2);
+		sites.emplace_back(0.8, 0.3);
+		sites.emplace_back(0.7, 0.9);
+		sites.emplace_back(0.1, 0.7);
+
+		Voronoi::Triangulation triangulation(sites);
+		auto triangles = triangulation.getTriangles();
+		CHECK_EQUAL(6u, triangles.size());
+		for (size_t i = 0; i < triangles.size(); i += 3) {
+			CHECK(Voronoi::orientation(sites[triangles[i]], sites[triangles[i + 1]], sites[triangles[i + 2]]) > 0.0);
+		}
+	}
+
+
+	TEST(Edges_SameAsGenerator)
+	{
+		const auto sites = randomSites(300, 3);
+		Voronoi::Triangulation triangulation(sites);
+		Voronoi::Generator generator(sites);
+
+		// The generator keeps the edges outside of the box
+		std::list<Voronoi::Edge> clipped;
+		for (auto edge : generator.getEdges()) {
+			if (Voronoi::clipEdge(edge, Voronoi::BoundingBox()) && edge.begin() != edge.end()) {
+				clipped.push_back(edge);
+			}
+		}
+		CHECK(sitePairs(clipped) == sitePairs(triangulation.getEdges()));
+	}
+
+
+	TEST(Edges_EndAlongDirection)
+	{
+		const auto sites = randomSites(50, 3);
+		Voronoi::Triangulation triangulation(sites);
+		for (const auto & edge : triangulation.getEdges()) {
+			// The end lies on the right of the line from the left site to the right one
+			const auto & left = sites[edge.leftSite()];
+			const auto & right = sites[edge.rightSite()];
+			const auto delta = edge.end() - edge.begin();
+			CHECK((right.y() - left.y()) * delta.x() + (left.x() - right.x()) * delta.y() > 0.0);
+		}
+	}
+
+
+	TEST(Pool_SameAsSequential)
+	{
+		const auto sites = randomSites(5000, 3);
+		Voronoi::ThreadPool pool(4);
+		std::vector<Voronoi::Edge> sequential;
+		std::vector<Voronoi::Edge> parallel;
+		Voronoi::generateEdges(sites, sequential, Voronoi::BoundingBox(), Voronoi::Engine::Delaunay);
+		Voronoi::generateEdges(sites, parallel, Voronoi::BoundingBox(), Voronoi::Engine::Delaunay, &pool);
+		CHECK_EQUAL(sequential.size(), parallel.size());
+		CHECK(sitePairs(sequential) == sitePairs(parallel));
+	}
+
+
+	TEST(DuplicateSites_Ignored)
+	{
+		std::vector<Voronoi::Point> sites;
+		sites.emplace_back(0.2, 0.2);
+		sites.emplace_back(0.8, 0.3);
+		sites.emplace_back(0.2, 0.2);
+		sites.emplace_back(0.5, 0.8);
+
+		Voronoi::Triangulation triangulation(sites);
+		CHECK_EQUAL(3u, triangulation.getTriangles().size());
+		CHECK_EQUAL(3u, triangulation.getEdges().size());
+	}
+
+
+	TEST(Grid_Delaunay)
+	{
+		// Rows of collinear sites and squares of cocircular ones
+		std::vector<Voronoi::Point> sites;
+		for (int i = 0; i < 10; ++i) {
+			for (int j = 0; j < 10; ++j) {
+				sites.emplace_back(0.05 + 0.1 * i, 0.05 + 0.1 * j);
+			}
+		}
+
+		Voronoi::Triangulation triangulation(sites);
+		// Two triangles per square of the grid
+		CHECK_EQUAL(2u * 9u * 9u * 3u, triangulation.getTriangles().size());
+		CHECK(isDelaunay(triangulation.getTriangles(), sites));
+	}
+
+
+	TEST(RoundedSites_Delaunay)
+	{
+		// Random sites rounded to a grid, the walk used to cycle on some of them
+		for (unsigned seed = 0; seed < 20; ++seed) {
+			auto sites = randomSites(29, seed);
+			for (auto & site : sites) {
+				site = Voronoi::Point(std::round(site.x() * 9) / 10 + 0.03, std::round(site.y() * 9) / 10 + 0.03);
+			}
+
+			Voronoi::Triangulation triangulation(sites);
+			CHECK(isDelaunay(triangulation.getTriangles(), sites));
+		}
+	}
+
+
+	TEST(CocircularSites_Delaunay)
+	{
+		// The center and twelve sites on the circle of radius 0.3125 with exact coordinates
+		std::vector<Voronoi::Point> sites;
+		sites.emplace_back(0.5, 0.5);
+		const double offsets[3][2] = { { 0.3125, 0.0 }, { 0.25, 0.1875 }, { 0.1875, 0.25 } };
+		for (const auto & offset : offsets) {
+			// Four quarter turns of the offset
+			sites.emplace_back(0.5 + offset[0], 0.5 + offset[1]);
+			sites.emplace_back(0.5 - offset[1], 0.5 + offset[0]);
+			sites.emplace_back(0.5 - offset[0], 0.5 - offset[1]);
+			sites.emplace_back(0.5 + offset[1], 0.5 - offset[0]);
+		}
+
+		Voronoi::Triangulation triangulation(sites);
+		CHECK_EQUAL(12u * 3u, triangulation.getTriangles().size());
+		CHECK_EQUAL(24u, triangulation.getEdges().size());
+		CHECK(isDelaunay(triangulation.getTriangles(), sites));
+	}
+
+
+	TEST(EngineFromName)
+	{
+		CHECK(Voronoi::engineFromName("delaunay") == Voronoi::Engine::Delaunay);
+		CHECK(Voronoi::engineFromName("fortune") == Voronoi::Engine::Fortune);
+		CHECK_THROW(Voronoi::engineFromName("sweep"), std::domain_error);
+	}
+}
@@ -0,0 +1,121 @@
+#include "tests.h"
+#include "diagramdiff.h"
+#include <algorithm>
+#include <map>
+#include <stdexcept>
+#include <utility>
+
+
+namespace
+{
+	/// Edges by the sorted pair of their sites
+	template <typename Edges>
+	std::map<std::pair<uint32_t, uint32_t>, Voronoi::Edge> edgeMap(const Edges & edges)
+	{
+		std::map<std::pair<uint32_t, uint32_t>, Voronoi::Edge> map;
+		for (const auto & edge : edges) {
+			map.emplace(std::make_pair(std::min(edge.leftSite(), edge.rightSite()), std::max(edge.leftSite(), edge.rightSite())), edge);
+		}
+		return map;
+	}
+}
+
+
+SUITE(DiagramDiffTest)
+{
+	TEST(SameDiagram_Empty)
+	{
+		const auto sites = randomSites(300, 1);
+		const Voronoi::Generator before(sites);
+		const Voronoi::Generator after(sites);
+		const Voronoi::DiagramDiff diff(before.getEdges(), after.getEdges());
+		CHECK(diff.isEmpty());
+		CHECK(diff.changedCells().empty());
+	}
+
+
+	TEST(MovedSite_PatchGivesNewDiagram)
+	{
+		auto sites = randomSites(300, 2);
+		const Voronoi::Generator before(sites);
+		sites[17] = sites[17] + Voronoi::Point(0.01, -0.02);
+		const Voronoi::Generator after(sites);
+		const Voronoi::DiagramDiff diff(before.getEdges(), after.getEdges());
+		CHECK(!diff.isEmpty());
+		CHECK(diff.addedCells().empty());
+		CHECK(diff.removedCells().empty());
+		CHECK(std::binary_search(diff.changedCells().begin(), diff.changedCells().end(), 17u));
+
+		// Only the neighbourhood of the site changes
+		CHECK(diff.changedEdges().size() + diff.addedEdges().size() + diff.removedEdges().size() < 40);
+
+		// The old diagram patched by the difference is the new one
+		auto patched = edgeMap(before.getEdges());
+		for (const auto & edge : diff.removedEdges()) {
+			patched.erase(std::make_pair(std::min(edge.leftSite(), edge.rightSite()), std::max(edge.leftSite(), edge.rightSite())));
+		}
+		for (const auto & edge : diff.changedEdges()) {
+			patched.at(std::make_pair(std::min(edge.leftSite(), edge.rightSite()), std::max(edge.leftSite(), edge.rightSite()))) = edge;
+		}
+		for (const auto & edge : diff.addedEdges()) {
+			CHECK(patched.emplace(std::make_pair(std::min(edge.leftSite(), edge.rightSite()), std::max(edge.leftSite(), edge.rightSite())), edge).second);
+		}
+		const auto expected = edgeMap(after.getEdges());
+		CHECK_EQUAL(expected.size(), patched.size());
+		for (const auto & item : expected) {
+			const auto it = patched.find(item.first);
+			CHECK(it != patched.end() && it->second.begin() == item.second.begin() && it->second.end() == item.second.end());
+		}
+	}
+
+
+	TEST(RemovedSite_MatchedByIds)
+	{
+		const auto sites = randomSites(200, 3);
+		std::vector<uint64_t> ids;
+		for (uint64_t i = 0; i < sites.size(); ++i) {
+			ids.push_back(1000 + i);
+		}
+
+		// Removing a site shifts the indices of the following ones, the ids stay
+		auto fewerSites = sites;
+		auto fewerIds = ids;
+		fewerSites.erase(fewerSites.begin() + 50);
+		fewerIds.erase(fewerIds.begin() + 50);
+		const Voronoi::Generator before(sites);
+		const Voronoi::Generator after(fewerSites);
+		const Voronoi::DiagramDiff diff(before.getEdges(), ids, after.getEdges(), fewerIds);
+		CHECK(diff.addedCells().empty());
+		CHECK_EQUAL(1u, diff.removedCells().size());
+		CHECK_EQUAL(1050u, diff.removedCells().front());
+		CHECK(!diff.changedCells().empty() && diff.changedCells().size() < 15);
+		for (const auto & edge : diff.removedEdges()) {
+			CHECK(edge.leftSite() < sites.size() && edge.rightSite() < sites.size());
+		}
+
+		// Without the ids the shifted indices look like a different diagram
+		const Voronoi::DiagramDiff byIndex(before.getEdges(), after.getEdges());
+		CHECK(byIndex.changedCells().size() > 100);
+
+		// And back again
+		const Voronoi::DiagramDiff reverse(after.getEdges(), fewerIds, before.getEdges(), ids);
+		CHECK_EQUAL(1u, reverse.addedCells().size());
+		CHECK_EQUAL(diff.changedCells().size(), reverse.changedCells().size());
+		CHECK_EQUAL(diff.removedEdges().size(), reverse.addedEdges().size());
+	}
+
+
+	TEST(Tolerance_IgnoresSmallMoves)
+	{
+		const auto sites = randomSites(100, 4);
+		const Voronoi::Generator before(sites);
+		std::vector<Voronoi::Edge> moved(before.getEdges().begin(), before.getEdges().end());
+		for (auto & edge : moved) {
+			edge.setBegin(edge.begin() + Voronoi::Point(1e-10, 0.0));
+		}
+		CHECK_EQUAL(moved.size(), Voronoi::DiagramDiff(before.getEdges(), moved).changedEdges().size());
+		CHECK(Voronoi::DiagramDiff(before.getEdges(), moved, 1e-9).isEmpty());
+		CHECK_THROW(Voronoi::DiagramDiff(before.getEdges(), std::vector<uint64_t>(), moved, std::vector<uint64_t>()),
+			std::out_of_range);
+	}
+}
@@ -0,0 +1,105 @@
+#include "tests.h"
+#include "eventqueue.h"
+#include <algorithm>
+#include <random>
+
+
+namespace
+{
+	/// Push events under a descending sweepline and pop those above it, like the generator does.
+	/// Return the "y" of the popped events in order.
+	template <typename Distribution>
+	std::vector<double> sweep(Voronoi::VertexEventQueue & queue, Distribution distribution)
+	{
+		std::mt19937 generator(1);
+		std::vector<double> popped;
+		for (double sweepline = 1.0; sweepline > 0.0; sweepline -= 0.001) {
+			while (!queue.empty() && queue.top()->site().y() >= sweepline) {
+				popped.push_back(queue.top()->site().y());
+				queue.pop();
+			}
+			for (int i = 0; i < 2; ++i) {
+				const double y = sweepline - distribution(generator);
+				queue.push(queue.create(Voronoi::Point(0.5, y)));
+			}
+		}
+		while (!queue.empty()) {
+			popped.push_back(queue.top()->site().y());
+			queue.pop();
+		}
+		return popped;
+	}
+}
+
+
+SUITE(EventQueueTest)
+{
+	TEST(Calendar_SameOrderAsHeap)
+	{
+		Voronoi::VertexEventQueue calendar;
+		calendar.reset(1.0, 0.0, 1000);
+		Voronoi::VertexEventQueue heap;
+		heap.reset(1.0, 0.0, 0);
+		CHECK(!heap.isCalendar());
+
+		// Some events fall below the calendar
+		std::exponential_distribution<double> distribution(50.0);
+		const auto calendarOrder = sweep(calendar, distribution);
+		const auto heapOrder = sweep(heap, distribution);
+		CHECK(calendar.isCalendar());
+		CHECK_EQUAL(2000u, calendarOrder.size());
+		CHECK(calendarOrder == heapOrder);
+		CHECK(std::is_sorted(calendarOrder.rbegin(), calendarOrder.rend()));
+	}
+
+
+	TEST(Calendar_FallbackOnSkew)
+	{
+		// Hundreds of pending events within a few buckets
+		Voronoi::VertexEventQueue calendar;
+		calendar.reset(1.0, 0.0, 10);
+		std::uniform_real_distribution<double> distribution(0.0, 0.3);
+		const auto order = sweep(calendar, distribution);
+		CHECK(!calendar.isCalendar());
+		CHECK_EQUAL(2000u, order.size());
+		CHECK(std::is_sorted(order.rbegin(), order.rend()));
+	}
+
+
+	TEST(Release_EventReused)
+	{
+		Voronoi::VertexEventQueue queue;
+		queue.push(queue.create(Voronoi::Point(0.2, 0.8)));
+		queue.top()->disable();
+		auto event = queue.pop();
+		const Voronoi::VertexEvent * memory = event.get();
+		queue.release(std::move(event));
+
+		auto reused = queue.create(Voronoi::Point(0.5, 0.5));
+		CHECK_EQUAL(memory, reused.get());
+		CHECK(!reused->isDisabled());
+		CHECK_EQUAL(0.5, reused->site().y());
+
+		const auto & statistics = queue.statistics();
+		CHECK_EQUAL(2u, statistics.Created);
+		CHECK_EQUAL(1u, statistics.Recycled);
+		CHECK_EQUAL(1u, statistics.Disabled);
+	}
+
+
+	TEST(Statistics_GeneratorReused)
+	{
+		const auto sites = randomSites(1000, 3);
+		Voronoi::Generator generator(sites);
+		const Voronoi::EventStatistics first = generator.getEventStatistics();
+		CHECK(first.Created > sites.size());
+		CHECK(first.Disabled > 0 && first.Disabled < first.Created);
+
+		// The same sweep again takes all events from the released ones
+		generator.generate(sites);
+		const Voronoi::EventStatistics & second = generator.getEventStatistics();
+		CHECK_EQUAL(first.Created, second.Created);
+		CHECK_EQUAL(first.Disabled, second.Disabled);
+		CHECK_EQUAL(second.Created, second.Recycled);
+	}
+}
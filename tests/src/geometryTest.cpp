@@ -1,6 +1,7 @@
 #include "tests.h"
 #include "geometry.h"
 #include "edge.h"
+#include <cmath>
 
 using namespace Voronoi;
 
@@ -11,9 +12,8 @@ SUITE(GeometryTest)
 {
 	TEST(EdgeIntersection)
 	{
-		const Point dummy(0.0, 0.0);
-		Edge left(dummy, dummy);
-		Edge right(dummy, dummy);
+		Edge left(0, 1);
+		Edge right(0, 1);
 		left.setBegin(Point(0, 1));
 		left.setEnd(Point(0, 5));
 		right.setBegin(Point(-1, 3));
@@ -27,9 +27,8 @@ SUITE(GeometryTest)
 
 	TEST(EdgeIntersection_NoIntersection)
 	{
-		const Point dummy(0.0, 0.0);
-		Edge left(dummy, dummy);
-		Edge right(dummy, dummy);
+		Edge left(0, 1);
+		Edge right(0, 1);
 		left.setBegin(Point(0, 1));
 		left.setEnd(Point(0, 5));
 		right.setBegin(Point(-1, 10));
@@ -40,6 +39,84 @@ SUITE(GeometryTest)
 	}
 
 
+	TEST(ClipEdge_Crossing_Clipped)
+	{
+		Edge edge(0, 1);
+		edge.setBegin(Point(-1, 0.5));
+		edge.setEnd(Point(2, 0.5));
+
+		CHECK(clipEdge(edge, BoundingBox(0, 1, 0, 1)));
+		CHECK_CLOSE(0.0, edge.begin().x(), Epsilon);
+		CHECK_CLOSE(0.5, edge.begin().y(), Epsilon);
+		CHECK_CLOSE(1.0, edge.end().x(), Epsilon);
+		CHECK_CLOSE(0.5, edge.end().y(), Epsilon);
+	}
+
+
+	TEST(ClipEdge_Inside_Unchanged)
+	{
+		Edge edge(0, 1);
+		edge.setBegin(Point(0.2, 0.3));
+		edge.setEnd(Point(0.7, 0.9));
+
+		CHECK(clipEdge(edge, BoundingBox(0, 1, 0, 1)));
+		CHECK(edge.begin() == Point(0.2, 0.3));
+		CHECK(edge.end() == Point(0.7, 0.9));
+	}
+
+
+	TEST(ClipEdge_Outside_False)
+	{
+		Edge edge(0, 1);
+		edge.setBegin(Point(1.5, -1));
+		edge.setEnd(Point(3, 0.5));
+
+		CHECK(!clipEdge(edge, BoundingBox(0, 1, 0, 1)));
+	}
+
+
+	TEST(Orientation_CounterClockwise_Positive)
+	{
+		CHECK(orientation(Point(0, 0), Point(1, 0), Point(1, 1)) > 0.0);
+	}
+
+
+	TEST(Orientation_Clockwise_Negative)
+	{
+		CHECK(orientation(Point(-1, 0), Point(0, 1), Point(1, 0)) < 0.0);
+	}
+
+
+	TEST(Orientation_Collinear_Zero)
+	{
+		CHECK_CLOSE(0.0, orientation(Point(0, 0), Point(1, 1), Point(2, 2)), Epsilon);
+		CHECK_CLOSE(0.0, orientation(Point(0, 0), Point(1, 1), Point(0, 0)), Epsilon);
+	}
+
+
+	TEST(Orientation_NearlyCollinear_ExactSign)
+	{
+		// The first point lies i - j units in the last place below the line y = x
+		const double unit = std::ldexp(1.0, -53);
+		for (int i = 0; i < 8; ++i) {
+			for (int j = 0; j < 8; ++j) {
+				const double value = orientation(Point(0.5 + i * unit, 0.5 + j * unit), Point(12, 12), Point(24, 24));
+				CHECK_EQUAL(j > i, value > 0.0);
+				CHECK_EQUAL(j < i, value < 0.0);
+			}
+		}
+	}
+
+
+	TEST(InCircle_Cocircular_Zero)
+	{
+		// Points on the circle around (0.5, 0.5) with radius 0.3125
+		CHECK_EQUAL(0.0, inCircle(Point(0.8125, 0.5), Point(0.5, 0.8125), Point(0.1875, 0.5), Point(0.6875, 0.75)));
+		CHECK_EQUAL(0.0, inCircle(Point(0.75, 0.6875), Point(0.3125, 0.75), Point(0.25, 0.3125), Point(0.6875, 0.25)));
+		CHECK(inCircle(Point(0.8125, 0.5), Point(0.5, 0.8125), Point(0.1875, 0.5), Point(0.5, 0.5)) > 0.0);
+	}
+
+
 	TEST(Circumcenter_010224_Correct)
 	{
 		auto center = circumcenter(Point(0, 1), Point(0, 2), Point(2, 4));
@@ -71,6 +148,25 @@ SUITE(GeometryTest)
 	}
 
 
+	TEST(Circumcenters_SameAsScalar)
+	{
+		// Five triples to run through both vectorized and scalar part
+		const Point a[] = { Point(0, 1), Point(2, 4), Point(2, 4), Point(0, 1), Point(-1, 0) };
+		const Point b[] = { Point(0, 2), Point(0, 2), Point(0, 1), Point(0, 1), Point(0, 3) };
+		const Point c[] = { Point(2, 4), Point(0, 1), Point(0, 2), Point(0, 2), Point(1, 0.5) };
+		Point centers[5];
+		circumcenters(a, b, c, centers, 5);
+		for (int i = 0; i < 5; ++i) {
+			const Point expected = circumcenter(a[i], b[i], c[i]);
+			CHECK_EQUAL(expected.isNull(), centers[i].isNull());
+			if (!expected.isNull()) {
+				CHECK_CLOSE(expected.x(), centers[i].x(), Epsilon);
+				CHECK_CLOSE(expected.y(), centers[i].y(), Epsilon);
+			}
+		}
+	}
+
+
 	TEST(CircumcircleRadius_010224_Correct)
 	{
 		auto radius = circumcircleRadius(Point(0, 1), Point(0, 2), Point(2, 4));
@@ -232,6 +328,18 @@ SUITE(GeometryTest)
 	}
 
 
+	TEST(ParabolaIntersectionsX_SameAsScalar)
+	{
+		const Point left[] = { Point(0, 0), Point(0, -1), Point(1, -1), Point(-1, 1), Point(0, 1) };
+		const Point right[] = { Point(1, 1), Point(0, 1), Point(0, 1), Point(1, 0), Point(1, -1) };
+		double x[5];
+		parabolaIntersectionsX(left, right, -5, x, 5);
+		for (int i = 0; i < 5; ++i) {
+			CHECK_CLOSE(parabolaIntersectionX(left[i], right[i], -5), x[i], Epsilon);
+		}
+	}
+
+
 	TEST(ParabolaIntersectionX_Universal_X)
 	{
 		const Point left(1, -1);
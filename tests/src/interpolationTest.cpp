@@ -0,0 +1,153 @@
+#include "tests.h"
+#include "interpolation.h"
+#include "delaunay.h"
+#include <cmath>
+#include <random>
+#include <stdexcept>
+
+
+namespace
+{
+	/// Areas of the cells, each edge makes a triangle with both of its sites
+	std::vector<double> cellAreas(const std::vector<Voronoi::Point> & sites)
+	{
+		std::vector<double> areas(sites.size(), 0.0);
+		const Voronoi::Generator generator(sites);
+		for (const auto & edge : generator.getEdges()) {
+			for (uint32_t site : { edge.leftSite(), edge.rightSite() }) {
+				const Voronoi::Point a = edge.begin() - sites[site];
+				const Voronoi::Point b = edge.end() - sites[site];
+				areas[site] += std::fabs(a.x() * b.y() - a.y() * b.x()) / 2.0;
+			}
+		}
+		return areas;
+	}
+
+
+	double linear(const Voronoi::Point & point)
+	{
+		return 2.0 * point.x() - 3.0 * point.y() + 1.0;
+	}
+}
+
+
+SUITE(InterpolationTest)
+{
+	TEST(Coordinates_StolenAreas)
+	{
+		const auto sites = randomSites(200, 1);
+		const Voronoi::Triangulation triangulation(sites);
+		const Voronoi::NaturalNeighbourInterpolator interpolator(triangulation, std::vector<double>(sites.size(), 0.0));
+		const Voronoi::Point point(0.43, 0.57);
+
+		// The cells before and after the point is added
+		const auto before = cellAreas(sites);
+		auto withPoint = sites;
+		withPoint.push_back(point);
+		const auto after = cellAreas(withPoint);
+
+		const auto coordinates = interpolator.coordinates(point);
+		CHECK(coordinates.size() >= 3);
+		double sum = 0.0;
+		for (const auto & neighbour : coordinates) {
+			CHECK_CLOSE((before[neighbour.first] - after[neighbour.first]) / after.back(), neighbour.second, 1e-9);
+			sum += neighbour.second;
+		}
+		CHECK_CLOSE(1.0, sum, 1e-12);
+	}
+
+
+	TEST(Interpolate_LinearFunctionExact)
+	{
+		const auto sites = randomSites(500, 2);
+		std::vector<double> values;
+		for (const auto & site : sites) {
+			values.push_back(linear(site));
+		}
+		const Voronoi::Triangulation triangulation(sites);
+		const Voronoi::NaturalNeighbourInterpolator interpolator(triangulation, values);
+		std::mt19937 generator(3);
+		std::uniform_real_distribution<double> distribution(0.1, 0.9);
+		for (int i = 0; i < 1000; ++i) {
+			const Voronoi::Point point(distribution(generator), distribution(generator));
+			CHECK_CLOSE(linear(point), interpolator.interpolate(point), 1e-9);
+		}
+
+		// A site gets its own value, no value outside of the hull
+		CHECK_EQUAL(values[7], interpolator.interpolate(sites[7]));
+		CHECK(std::isnan(interpolator.interpolate(Voronoi::Point(1.5, 0.5))));
+		CHECK(interpolator.coordinates(Voronoi::Point(-0.5, 0.5)).empty());
+		CHECK_THROW(Voronoi::NaturalNeighbourInterpolator(triangulation, std::vector<double>(3)), std::invalid_argument);
+	}
+
+
+	TEST(Interpolate_SitesOnGrid_LinearFunctionExact)
+	{
+		// Cocircular sites, the queries inside of the hull lie on their edges and in the centers of the cells too
+		std::vector<Voronoi::Point> sites;
+		std::vector<double> values;
+		for (int i = 0; i < 9; ++i) {
+			for (int j = 0; j < 9; ++j) {
+				sites.emplace_back(0.1 + 0.1 * i, 0.1 + 0.1 * j);
+				values.push_back(linear(sites.back()));
+			}
+		}
+		const Voronoi::Triangulation triangulation(sites);
+		const Voronoi::NaturalNeighbourInterpolator interpolator(triangulation, values);
+		for (int y = 1; y < 32; ++y) {
+			for (int x = 1; x < 32; ++x) {
+				const Voronoi::Point point(0.1 + 0.025 * x, 0.1 + 0.025 * y);
+				CHECK_CLOSE(linear(point), interpolator.interpolate(point), 1e-9);
+			}
+		}
+	}
+
+
+	TEST(Interpolate_RoundedSites_LinearFunctionExact)
+	{
+		// Random sites rounded to a grid, the walk to the queries used to cycle on some of them
+		for (unsigned seed = 0; seed < 20; ++seed) {
+			auto sites = randomSites(29, seed);
+			std::vector<double> values;
+			for (auto & site : sites) {
+				site = Voronoi::Point(std::round(site.x() * 9) / 10 + 0.03, std::round(site.y() * 9) / 10 + 0.03);
+				values.push_back(linear(site));
+			}
+			const Voronoi::Triangulation triangulation(sites);
+			const Voronoi::NaturalNeighbourInterpolator interpolator(triangulation, values);
+			for (int y = 0; y <= 36; ++y) {
+				for (int x = 0; x <= 36; ++x) {
+					// No value outside of the hull
+					const Voronoi::Point point(0.03 + 0.025 * x, 0.03 + 0.025 * y);
+					const double value = interpolator.interpolate(point);
+					CHECK(std::isnan(value) || std::fabs(linear(point) - value) <= 1e-9);
+				}
+			}
+		}
+	}
+
+
+	TEST(Interpolate_GridSameInPool)
+	{
+		const auto sites = randomSites(1000, 4);
+		std::vector<double> values;
+		for (const auto & site : sites) {
+			values.push_back(std::sin(6.0 * site.x()) * std::cos(4.0 * site.y()));
+		}
+		const Voronoi::Triangulation triangulation(sites);
+		const Voronoi::NaturalNeighbourInterpolator interpolator(triangulation, values);
+		std::vector<Voronoi::Point> grid;
+		for (int y = 0; y < 64; ++y) {
+			for (int x = 0; x < 64; ++x) {
+				grid.emplace_back((x + 0.5) / 64.0, (y + 0.5) / 64.0);
+			}
+		}
+		Voronoi::ThreadPool pool(4);
+		std::vector<double> results(grid.size());
+		interpolator.interpolate(grid.data(), grid.size(), results.data(), &pool);
+		for (size_t i = 0; i < grid.size(); ++i) {
+			const double expected = interpolator.interpolate(grid[i]);
+			CHECK((std::isnan(expected) && std::isnan(results[i])) || expected == results[i]);
+		}
+	}
+}
@@ -0,0 +1,103 @@
+#include "tests.h"
+#include "kinetic.h"
+#include <random>
+
+
+SUITE(KineticTest)
+{
+	TEST(Static_NoFlips)
+	{
+		std::mt19937 generator(1);
+		std::uniform_real_distribution<double> distribution(0.1, 0.9);
+		std::vector<Voronoi::Point> sites;
+		for (int i = 0; i < 200; ++i) {
+			const double x = distribution(generator);
+			sites.emplace_back(x, distribution(generator));
+		}
+		Voronoi::KineticDiagram diagram(sites, std::vector<Voronoi::Point>(sites.size(), Voronoi::Point(0.0, 0.0)));
+		diagram.advance(10.0);
+		CHECK_EQUAL(0u, diagram.flipCount());
+		CHECK_EQUAL(10.0, diagram.time());
+		CHECK(sitePairs(diagram.getEdges()) == sitePairs(Voronoi::Triangulation(sites).getEdges()));
+	}
+
+
+	TEST(Moving_SameAsTriangulation)
+	{
+		std::mt19937 generator(2);
+		std::uniform_real_distribution<double> position(0.3, 0.7);
+		std::uniform_real_distribution<double> speed(-0.05, 0.05);
+		std::vector<Voronoi::Point> sites;
+		std::vector<Voronoi::Point> velocities;
+		for (int i = 0; i < 300; ++i) {
+			const double x = position(generator);
+			sites.emplace_back(x, position(generator));
+			const double vx = speed(generator);
+			velocities.emplace_back(vx, speed(generator));
+		}
+
+		Voronoi::KineticDiagram diagram(sites, velocities);
+		for (int tick = 0; tick < 20; ++tick) {
+			diagram.advance(0.1);
+			if (tick == 10) {
+				// Turn some sites around
+				for (uint32_t i = 0; i < 300; i += 7) {
+					diagram.setVelocity(i, Voronoi::Point(-velocities[i].x(), -velocities[i].y()));
+				}
+			}
+		}
+		CHECK(diagram.flipCount() > 0);
+
+		// The sites keep moving along their lines
+		CHECK(std::abs(diagram.getSites()[1].x() - (sites[1].x() + 2.0 * velocities[1].x())) < 1e-12);
+		CHECK(std::abs(diagram.getSites()[7].x() - (sites[7].x() + 0.2 * velocities[7].x())) < 1e-12);
+
+		const Voronoi::Triangulation rebuilt(diagram.getSites());
+		CHECK(sitePairs(diagram.getEdges()) == sitePairs(rebuilt.getEdges()));
+		auto triangles = diagram.getTriangles();
+		CHECK_EQUAL(rebuilt.getTriangles().size(), triangles.size());
+	}
+
+
+	TEST(Grid_Rectangles_NoFlips)
+	{
+		// The columns and the rows move at different speeds, the cells stay cocircular rectangles
+		std::vector<Voronoi::Point> sites;
+		std::vector<Voronoi::Point> velocities;
+		for (int i = 0; i < 6; ++i) {
+			for (int j = 0; j < 6; ++j) {
+				sites.emplace_back(0.05 + 0.1 * i, 0.05 + 0.1 * j);
+				velocities.emplace_back(0.01 * (i % 4), 0.02 * (j % 3));
+			}
+		}
+
+		Voronoi::KineticDiagram diagram(sites, velocities);
+		for (int tick = 0; tick < 10; ++tick) {
+			diagram.advance(0.1);
+		}
+		CHECK_EQUAL(0u, diagram.flipCount());
+		CHECK(isDelaunay(diagram.getTriangles(), diagram.getSites()));
+	}
+
+
+	TEST(Grid_ShearedRows_Delaunay)
+	{
+		// The odd rows slide by a whole cell, the sites are cocircular again in the middle of a tick
+		std::vector<Voronoi::Point> sites;
+		std::vector<Voronoi::Point> velocities;
+		for (int i = 0; i < 8; ++i) {
+			for (int j = 0; j < 10; ++j) {
+				sites.emplace_back(0.05 + 0.1 * i, 0.05 + 0.1 * j);
+				velocities.emplace_back(j % 2 == 1 ? 0.1 : 0.0, 0.0);
+			}
+		}
+
+		Voronoi::KineticDiagram diagram(sites, velocities);
+		for (int tick = 0; tick < 13; ++tick) {
+			diagram.advance(0.15);
+			CHECK(isDelaunay(diagram.getTriangles(), diagram.getSites()));
+		}
+		CHECK(diagram.flipCount() > 0);
+		CHECK_EQUAL(Voronoi::Triangulation(diagram.getSites()).getTriangles().size(), diagram.getTriangles().size());
+	}
+}
@@ -0,0 +1,131 @@
+#include "tests.h"
+#include "memoryresource.h"
+#include <cstdint>
+
+
+namespace
+{
+	/// Count the memory taken from the global heap
+	class CountingResource : public Voronoi::MemoryResource
+	{
+	public:
+		CountingResource() : allocations(0), bytes(0) {}
+
+		size_t allocations;
+		size_t bytes;  ///< Not deallocated yet
+
+	protected:
+		void * _allocate(size_t size, size_t alignment) override
+		{
+			++allocations;
+			bytes += size;
+			return Voronoi::newDeleteResource()->allocate(size, alignment);
+		}
+
+		void _deallocate(void * pointer, size_t size, size_t alignment) override
+		{
+			bytes -= size;
+			Voronoi::newDeleteResource()->deallocate(pointer, size, alignment);
+		}
+	};
+}
+
+
+SUITE(MemoryResourceTest)
+{
+	TEST(MonotonicBuffer_Aligned)
+	{
+		CountingResource upstream;
+		Voronoi::MonotonicBuffer buffer(256, &upstream);
+		buffer.allocate(1, 1);
+		void * aligned = buffer.allocate(24, 16);
+		CHECK_EQUAL(0u, reinterpret_cast<uintptr_t>(aligned) % 16);
+
+		// Bigger than the block
+		buffer.allocate(1000, 8);
+		CHECK_EQUAL(2u, upstream.allocations);
+		CHECK_EQUAL(upstream.bytes, buffer.upstreamSize());
+
+		// The larger block is kept for the next allocations
+		buffer.release();
+		CHECK_EQUAL(upstream.bytes, buffer.upstreamSize());
+		CHECK(buffer.upstreamSize() > 1000);
+		buffer.allocate(1000, 8);
+		CHECK_EQUAL(2u, upstream.allocations);
+	}
+
+
+	TEST(MonotonicBuffer_InitialBuffer)
+	{
+		CountingResource upstream;
+		alignas(16) char memory[1024];
+		Voronoi::MonotonicBuffer buffer(memory, sizeof(memory), &upstream);
+		char * first = static_cast<char *>(buffer.allocate(100, 8));
+		CHECK(first >= memory && first + 100 <= memory + sizeof(memory));
+		CHECK_EQUAL(0u, upstream.allocations);
+	}
+
+
+	TEST(Generator_AllMemoryFromResource)
+	{
+		const auto sites = randomSites(500, 1);
+		const Voronoi::Generator reference(sites);
+
+		CountingResource resource;
+		{
+			Voronoi::Generator generator(sites, Voronoi::BoundingBox(), &resource);
+			auto mesh = generator.getMesh();
+			CHECK(resource.allocations > 0);
+			CHECK_EQUAL(reference.getEdges().size(), generator.getEdges().size());
+			CHECK(mesh.edges.get_allocator().resource() == &resource);
+		}
+		CHECK_EQUAL(0u, resource.bytes);
+	}
+
+
+	TEST(Generator_MonotonicBuffer)
+	{
+		const auto sites = randomSites(500, 2);
+		const Voronoi::Generator reference(sites);
+
+		CountingResource upstream;
+		Voronoi::MonotonicBuffer buffer(4096, &upstream);
+		{
+			Voronoi::Generator generator(sites, Voronoi::BoundingBox(), &buffer);
+			CHECK_EQUAL(reference.getEdges().size(), generator.getEdges().size());
+			auto it = reference.getEdges().begin();
+			for (const auto & edge : generator.getEdges()) {
+				CHECK_EQUAL(it->leftSite(), edge.leftSite());
+				CHECK_EQUAL(it->rightSite(), edge.rightSite());
+				++it;
+			}
+		}
+
+		// A few growing blocks, all but the largest one freed at once
+		CHECK(upstream.allocations < 20);
+		buffer.release();
+		CHECK_EQUAL(upstream.bytes, buffer.upstreamSize());
+	}
+
+
+	TEST(MonotonicBuffer_ReleaseReusesBlock)
+	{
+		CountingResource upstream;
+		{
+			Voronoi::MonotonicBuffer buffer(4096, &upstream);
+			std::vector<size_t> allocations;
+			for (unsigned round = 0; round < 6; ++round) {
+				{
+					Voronoi::Generator generator(randomSites(500, round), Voronoi::BoundingBox(), &buffer);
+					CHECK(!generator.getEdges().empty());
+				}
+				buffer.release();
+				allocations.push_back(upstream.allocations);
+			}
+
+			// No upstream allocation once the kept block holds a whole diagram
+			CHECK_EQUAL(allocations[2], allocations.back());
+		}
+		CHECK_EQUAL(0u, upstream.bytes);
+	}
+}
@@ -9,7 +9,7 @@ TEST(A)
 
 	Voronoi::Generator generator(sites);
 	auto edges = generator.getEdges();
-	printEdges(edges, 'A');
+	printEdges(edges, sites, 'A');
 
 
 	//const Voronoi::Point e_1(0.0, 0.3);
@@ -27,7 +27,7 @@ TEST(B)
 
 	Voronoi::Generator generator(sites);
 	auto edges = generator.getEdges();
-	printEdges(edges, 'B');
+	printEdges(edges, sites, 'B');
 
 	//const Voronoi::Point b_2(0.0, 0.28);
 	//const Voronoi::Point e_2(1.0, 0.48);
@@ -44,7 +44,7 @@ TEST(C)
 
 	Voronoi::Generator generator(sites);
 	auto edges = generator.getEdges();
-	printEdges(edges, 'C');
+	printEdges(edges, sites, 'C');
 
 	//const Voronoi::Point b_3(0.225, 0);
 	//const Voronoi::Point e_3(0.45, 0.45);
@@ -62,7 +62,7 @@ TEST(D)
 
 	Voronoi::Generator generator(sites);
 	auto edges = generator.getEdges();
-	printEdges(edges, 'D');
+	printEdges(edges, sites, 'D');
 }
 
 
@@ -76,7 +76,7 @@ TEST(H)
 
 	Voronoi::Generator generator(sites);
 	auto edges = generator.getEdges();
-	printEdges(edges, 'H');
+	printEdges(edges, sites, 'H');
 }
 
 
@@ -90,7 +90,7 @@ TEST(I)
 
 	Voronoi::Generator generator(sites);
 	auto edges = generator.getEdges();
-	printEdges(edges, 'I');
+	printEdges(edges, sites, 'I');
 }
 
 
@@ -104,7 +104,7 @@ TEST(E)
 
 	Voronoi::Generator generator(sites);
 	auto edges = generator.getEdges();
-	printEdges(edges, 'E');
+	printEdges(edges, sites, 'E');
 }
 
 
@@ -118,7 +118,7 @@ TEST(G)
 
 	Voronoi::Generator generator(sites);
 	auto edges = generator.getEdges();
-	printEdges(edges, 'G');
+	printEdges(edges, sites, 'G');
 }
 
 
@@ -132,5 +132,5 @@ TEST(F)
 
 	Voronoi::Generator generator(sites);
 	auto edges = generator.getEdges();
-	printEdges(edges, 'F');
+	printEdges(edges, sites, 'F');
 }
@@ -0,0 +1,80 @@
+#include "tests.h"
+#include "smallgenerator.h"
+#include "engine.h"
+#include "voronoi.h"
+#include "geometry.h"
+
+
+SUITE(SmallGeneratorTest)
+{
+	TEST(FixedVector_Full)
+	{
+		Voronoi::FixedVector<int, 2> vector;
+		vector.push_back(1);
+		vector.push_back(2);
+		CHECK_EQUAL(2u, vector.size());
+		CHECK_THROW(vector.push_back(3), std::length_error);
+	}
+
+
+	TEST(TwoSites_OneEdge)
+	{
+		std::vector<Voronoi::Point> sites;
+		sites.emplace_back(0.2, 0.5);
+		sites.emplace_back(0.8, 0.5);
+
+		Voronoi::SmallGenerator<8> generator(sites);
+		const auto & edges = generator.getEdges();
+		CHECK_EQUAL(1u, edges.size());
+		CHECK_CLOSE(0.5, edges[0].begin().x(), 1e-12);
+		CHECK_CLOSE(1.0, edges[0].begin().y(), 1e-12);
+		CHECK_CLOSE(0.0, edges[0].end().y(), 1e-12);
+	}
+
+
+	TEST(RandomSites_SameAsGenerator)
+	{
+		for (unsigned seed = 0; seed < 20; ++seed) {
+			const auto sites = randomSites(3 + seed * 3, seed);
+			Voronoi::SmallGenerator<64> small(sites);
+			Voronoi::Generator generator(sites);
+
+			// The generator keeps the edges outside of the box
+			std::list<Voronoi::Edge> clipped;
+			for (auto edge : generator.getEdges()) {
+				if (Voronoi::clipEdge(edge, Voronoi::BoundingBox()) && edge.begin() != edge.end()) {
+					clipped.push_back(edge);
+				}
+			}
+			CHECK(sitePairs(clipped) == sitePairs(small.getEdges()));
+		}
+	}
+
+
+	TEST(GenerateEdges_SameAroundThreshold)
+	{
+		// The small path and the sweep must both clip the edges to the box
+		std::vector<Voronoi::Edge> edges;
+		for (size_t count : { Voronoi::SmallSiteCount, Voronoi::SmallSiteCount + 1 }) {
+			const auto sites = randomSites(count, 7);
+			Voronoi::generateEdges(sites, edges);
+			const Voronoi::BoundingBox box;
+			for (const auto & edge : edges) {
+				CHECK(edge.begin().x() >= box.MinX - 1e-9 && edge.begin().x() <= box.MaxX + 1e-9);
+				CHECK(edge.begin().y() >= box.MinY - 1e-9 && edge.begin().y() <= box.MaxY + 1e-9);
+				CHECK(edge.end().x() >= box.MinX - 1e-9 && edge.end().x() <= box.MaxX + 1e-9);
+				CHECK(edge.end().y() >= box.MinY - 1e-9 && edge.end().y() <= box.MaxY + 1e-9);
+			}
+
+			std::vector<Voronoi::Edge> delaunay;
+			Voronoi::generateEdges(sites, delaunay, box, Voronoi::Engine::Delaunay);
+			CHECK(sitePairs(delaunay) == sitePairs(edges));
+		}
+	}
+
+
+	TEST(TooManySites_Throws)
+	{
+		CHECK_THROW(Voronoi::SmallGenerator<4>(randomSites(5, 1)), std::length_error);
+	}
+}
@@ -1,37 +1,68 @@
 #include "tests.h"
+#include "geometry.h"
 #include <iostream>
+#include <random>
 
-
-namespace
-{
-	/// Helper function for `printEdges`
-	std::string printPoint(const Voronoi::Point & point)
-	{
-		if (point.isNull()) {
-			return "(-, -)";
-		}
-		else {
-			std::ostringstream str;
-			str << "(" << point.x() << ", " << point.y() << ")";
-			return str.str();
-		}
-	}
-}
-
-
-void printEdges(const std::list<Voronoi::Edge> & edges, char test)
-{
-	std::cout << "\n --Test " << test << "--" << std::endl;
-	for (const auto & edge : edges) {
-		const auto begin = edge.begin();
-		const auto end = edge.end();
-		const auto left = edge.left();
-		const auto right = edge.right();
-		std::ostringstream str;
-		str << "beg" << printPoint(edge.begin()) << " -> " << printPoint(edge.end());
-		for (std::streamoff i = str.tellp(); i < 37; ++i) str << " ";
-		str << "[left" << printPoint(edge.left()) << "; right" << printPoint(edge.right()) << "]\n";
-		std::cout << str.str();
-	}
+
+namespace
+{
+	/// Helper function for `printEdges`
+	std::string printPoint(const Voronoi::Point & point)
+	{
+		if (point.isNull()) {
+			return "(-, -)";
+		}
+		else {
+			std::ostringstream str;
+			str << "(" << point.x() << ", " << point.y() << ")";
+			return str.str();
+		}
+	}
 }
 
+
+void printEdges(const Voronoi::EdgeList & edges, const std::vector<Voronoi::Point> & sites, char test)
+{
+	std::cout << "\n --Test " << test << "--" << std::endl;
+	for (const auto & edge : edges) {
+		const auto begin = edge.begin();
+		const auto end = edge.end();
+		std::ostringstream str;
+		str << "beg" << printPoint(edge.begin()) << " -> " << printPoint(edge.end());
+		for (std::streamoff i = str.tellp(); i < 37; ++i) str << " ";
+		str << "[left" << printPoint(sites[edge.leftSite()]) << "; right" << printPoint(sites[edge.rightSite()]) << "]\n";
+		std::cout << str.str();
+	}
+}
+
+
+std::vector<Voronoi::Point> randomSites(size_t count, unsigned seed)
+{
+	std::mt19937 generator(seed);
+	std::uniform_real_distribution<double> distribution(0.01, 0.99);
+	std::vector<Voronoi::Point> sites;
+	for (size_t i = 0; i < count; ++i) {
+		const double x = distribution(generator);
+		sites.emplace_back(x, distribution(generator));
+	}
+	return sites;
+}
+
+
+bool isDelaunay(const std::vector<uint32_t> & triangles, const std::vector<Voronoi::Point> & sites)
+{
+	for (size_t i = 0; i < triangles.size(); i += 3) {
+		const auto & a = sites[triangles[i]];
+		const auto & b = sites[triangles[i + 1]];
+		const auto & c = sites[triangles[i + 2]];
+		if (Voronoi::orientation(a, b, c) <= 0.0) {
+			return false;
+		}
+		for (const auto & site : sites) {
+			if (Voronoi::inCircle(a, b, c, site) > 0.0) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
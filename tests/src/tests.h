@@ -3,10 +3,32 @@
 
 #include "voronoi.h"
 #include "UnitTest++.h"
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <cstdint>
 
 
 /// Simple debug function to print all edges
-void printEdges(const std::list<Voronoi::Edge> & edges, char test);
+void printEdges(const Voronoi::EdgeList & edges, const std::vector<Voronoi::Point> & sites, char test);
+
+/// Sites spread uniformly over [0.01, 0.99]^2, the same for the same seed
+std::vector<Voronoi::Point> randomSites(size_t count, unsigned seed);
+
+/// True if the counter-clockwise triangles [a0, b0, c0, ...] have no site inside their circumcircles
+bool isDelaunay(const std::vector<uint32_t> & triangles, const std::vector<Voronoi::Point> & sites);
+
+/// Sorted site pairs of the edges
+template <typename Edges>
+std::vector<std::pair<uint32_t, uint32_t>> sitePairs(const Edges & edges)
+{
+	std::vector<std::pair<uint32_t, uint32_t>> pairs;
+	for (const auto & edge : edges) {
+		pairs.emplace_back(std::min(edge.leftSite(), edge.rightSite()), std::max(edge.leftSite(), edge.rightSite()));
+	}
+	std::sort(pairs.begin(), pairs.end());
+	return pairs;
+}
 
 
 #endif  // TESTS_H
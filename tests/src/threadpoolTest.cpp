@@ -0,0 +1,72 @@
+#include "tests.h"
+#include "threadpool.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <random>
+#include <stdexcept>
+
+
+SUITE(ThreadPoolTest)
+{
+	TEST(ParallelFor_CoversRange)
+	{
+		Voronoi::ThreadPool pool(3);
+		std::vector<int> counts(1000, 0);
+		pool.parallelFor(counts.size(), [&counts](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; ++i) {
+				++counts[i];
+			}
+		});
+		CHECK(std::count(counts.begin(), counts.end(), 1) == 1000);
+	}
+
+
+	TEST(Run_RethrowsException)
+	{
+		Voronoi::ThreadPool pool(2);
+		std::atomic<int> finished(0);
+		std::vector<std::function<void()>> tasks;
+		tasks.emplace_back([]() { throw std::runtime_error("task"); });
+		tasks.emplace_back([&finished]() { ++finished; });
+		CHECK_THROW(pool.run(tasks), std::runtime_error);
+		CHECK_EQUAL(1, finished.load());
+	}
+
+
+	TEST(Post_NotTakenByRun)
+	{
+		// The worker blocks in the first posted task, the caller of `run` must leave the second one
+		Voronoi::ThreadPool pool(2);
+		std::promise<void> release;
+		std::shared_future<void> released = release.get_future().share();
+		std::atomic<int> started(0);
+		for (int i = 0; i < 2; ++i) {
+			pool.post([released, &started]() {
+				++started;
+				released.wait_for(std::chrono::seconds(10));
+			});
+		}
+		std::atomic<int> finished(0);
+		std::vector<std::function<void()>> tasks(10, [&finished]() { ++finished; });
+		pool.run(tasks);
+		CHECK_EQUAL(10, finished.load());
+		CHECK(started.load() <= 1);
+		release.set_value();
+	}
+
+
+	TEST(ParallelSort_Sorted)
+	{
+		std::mt19937 generator(5);
+		std::vector<uint32_t> values(100000);
+		for (auto & value : values) {
+			value = generator();
+		}
+		Voronoi::ThreadPool pool(4);
+		Voronoi::parallelSort(&pool, values.begin(), values.end(), std::less<uint32_t>());
+		CHECK(std::is_sorted(values.begin(), values.end()));
+	}
+}
@@ -0,0 +1,94 @@
+#include "tests.h"
+#include "tiling.h"
+#include "geometry.h"
+#include <thread>
+
+
+SUITE(TilingTest)
+{
+	TEST(Tiles_SeamsMatch)
+	{
+		const auto sites = randomSites(200, 7);
+		Voronoi::TilingOptions options;
+		options.Columns = 3;
+		options.Rows = 2;
+		Voronoi::TiledGenerator generator(sites, Voronoi::BoundingBox(), options);
+		auto edges = generator.getEdges();
+
+		CHECK_EQUAL(0u, generator.seamMismatches());
+		CHECK(!edges.empty());
+		for (const auto & edge : edges) {
+			CHECK(edge.leftSite() < sites.size() && edge.rightSite() < sites.size());
+			CHECK(edge.begin().x() >= 0.0 && edge.begin().x() <= 1.0);
+			CHECK(edge.end().y() >= 0.0 && edge.end().y() <= 1.0);
+		}
+	}
+
+
+	TEST(OneTile_SameAsGenerator)
+	{
+		const auto sites = randomSites(50, 7);
+		Voronoi::TilingOptions options;
+		options.Columns = 1;
+		options.Rows = 1;
+		Voronoi::TiledGenerator tiled(sites, Voronoi::BoundingBox(), options);
+		Voronoi::Generator generator(sites);
+
+		// The tile keeps the parts of the edges inside the bounding box
+		size_t count = 0;
+		for (auto edge : generator.getEdges()) {
+			count += Voronoi::clipEdge(edge, Voronoi::BoundingBox()) ? 1 : 0;
+		}
+		CHECK_EQUAL(count, tiled.getEdges().size());
+	}
+
+
+	TEST(ManyTiles_SameAsGenerator)
+	{
+		// Sites in the halos of several tiles at once, the tile sizes don't divide the box exactly
+		const auto sites = randomSites(2000, 8);
+		Voronoi::TilingOptions options;
+		options.Columns = 7;
+		options.Rows = 5;
+		Voronoi::TiledGenerator tiled(sites, Voronoi::BoundingBox(), options);
+		CHECK_EQUAL(0u, tiled.seamMismatches());
+
+		const Voronoi::Generator generator(sites);
+		std::vector<Voronoi::Edge> clipped;
+		for (auto edge : generator.getEdges()) {
+			if (Voronoi::clipEdge(edge, Voronoi::BoundingBox()) && edge.begin() != edge.end()) {
+				clipped.push_back(edge);
+			}
+		}
+		CHECK(sitePairs(clipped) == sitePairs(tiled.getEdges()));
+	}
+
+
+	TEST(ConcurrentRuns_SameDirectory)
+	{
+		// Each run has its own tile files
+		const auto sites = randomSites(500, 9);
+		const Voronoi::TiledGenerator expected(sites);
+		std::vector<std::list<Voronoi::Edge>> edges(4);
+		std::vector<std::thread> runs;
+		for (size_t i = 0; i < edges.size(); ++i) {
+			runs.emplace_back([&sites, &edges, i]() {
+				edges[i] = Voronoi::TiledGenerator(sites).getEdges();
+			});
+		}
+		for (auto & run : runs) {
+			run.join();
+		}
+		for (const auto & runEdges : edges) {
+			CHECK(sitePairs(runEdges) == sitePairs(expected.getEdges()));
+		}
+	}
+
+
+	TEST(Periodic_Throws)
+	{
+		Voronoi::BoundingBox box;
+		box.Periodic = true;
+		CHECK_THROW(Voronoi::TiledGenerator(randomSites(10, 7), box), std::domain_error);
+	}
+}
@@ -1,4 +1,63 @@
 #include "tests.h"
+#include "geometry.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+
+
+namespace
+{
+	/// True if both lists have the same edges in any order and direction
+	bool sameEdges(const Voronoi::EdgeList & left, const Voronoi::EdgeList & right)
+	{
+		typedef std::tuple<uint32_t, uint32_t, double, double, double, double> Key;
+		auto keys = [](const Voronoi::EdgeList & edges) {
+			std::vector<Key> keys;
+			for (const auto & edge : edges) {
+				Voronoi::Point begin = edge.begin();
+				Voronoi::Point end = edge.end();
+				if (edge.leftSite() > edge.rightSite()) {
+					std::swap(begin, end);
+				}
+				keys.emplace_back(std::min(edge.leftSite(), edge.rightSite()), std::max(edge.leftSite(), edge.rightSite()),
+					begin.x(), begin.y(), end.x(), end.y());
+			}
+			std::sort(keys.begin(), keys.end());
+			return keys;
+		};
+		const auto leftKeys = keys(left);
+		const auto rightKeys = keys(right);
+		if (leftKeys.size() != rightKeys.size()) {
+			return false;
+		}
+		for (size_t i = 0; i < leftKeys.size(); ++i) {
+			if (std::get<0>(leftKeys[i]) != std::get<0>(rightKeys[i]) || std::get<1>(leftKeys[i]) != std::get<1>(rightKeys[i]) ||
+				std::fabs(std::get<2>(leftKeys[i]) - std::get<2>(rightKeys[i])) > 1e-9 ||
+				std::fabs(std::get<3>(leftKeys[i]) - std::get<3>(rightKeys[i])) > 1e-9 ||
+				std::fabs(std::get<4>(leftKeys[i]) - std::get<4>(rightKeys[i])) > 1e-9 ||
+				std::fabs(std::get<5>(leftKeys[i]) - std::get<5>(rightKeys[i])) > 1e-9) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+
+	/// Edges clipped to the box, the sweep keeps the vertices of finished edges outside of it
+	Voronoi::EdgeList clipEdges(const Voronoi::EdgeList & edges, const Voronoi::BoundingBox & box)
+	{
+		Voronoi::EdgeList clipped;
+		for (auto edge : edges) {
+			if (Voronoi::clipEdge(edge, box) && edge.begin() != edge.end()) {
+				clipped.push_back(edge);
+			}
+		}
+		return clipped;
+	}
+}
 
 
 SUITE(VoronoiTest)
@@ -11,7 +70,7 @@ SUITE(VoronoiTest)
 
 		Voronoi::Generator generator(sites);
 		auto edges = generator.getEdges();
-		printEdges(edges, 'A');
+		printEdges(edges, sites, 'A');
 
 
 		//const Voronoi::Point e_1(0.0, 0.3);
@@ -29,7 +88,7 @@ SUITE(VoronoiTest)
 
 		Voronoi::Generator generator(sites);
 		auto edges = generator.getEdges();
-		printEdges(edges, 'B');
+		printEdges(edges, sites, 'B');
 
 		//const Voronoi::Point b_2(0.0, 0.28);
 		//const Voronoi::Point e_2(1.0, 0.48);
@@ -46,7 +105,7 @@ SUITE(VoronoiTest)
 
 		Voronoi::Generator generator(sites);
 		auto edges = generator.getEdges();
-		printEdges(edges, 'C');
+		printEdges(edges, sites, 'C');
 
 		//const Voronoi::Point b_3(0.225, 0);
 		//const Voronoi::Point e_3(0.45, 0.45);
@@ -64,7 +123,7 @@ SUITE(VoronoiTest)
 
 		Voronoi::Generator generator(sites);
 		auto edges = generator.getEdges();
-		printEdges(edges, 'D');
+		printEdges(edges, sites, 'D');
 	}
 
 
@@ -78,7 +137,7 @@ SUITE(VoronoiTest)
 
 		Voronoi::Generator generator(sites);
 		auto edges = generator.getEdges();
-		printEdges(edges, 'H');
+		printEdges(edges, sites, 'H');
 	}
 
 
@@ -92,7 +151,7 @@ SUITE(VoronoiTest)
 
 		Voronoi::Generator generator(sites);
 		auto edges = generator.getEdges();
-		printEdges(edges, 'I');
+		printEdges(edges, sites, 'I');
 	}
 
 
@@ -106,7 +165,7 @@ SUITE(VoronoiTest)
 
 		Voronoi::Generator generator(sites);
 		auto edges = generator.getEdges();
-		printEdges(edges, 'E');
+		printEdges(edges, sites, 'E');
 	}
 
 
@@ -120,7 +179,7 @@ SUITE(VoronoiTest)
 
 		Voronoi::Generator generator(sites);
 		auto edges = generator.getEdges();
-		printEdges(edges, 'G');
+		printEdges(edges, sites, 'G');
 	}
 
 
@@ -134,7 +193,435 @@ SUITE(VoronoiTest)
 
 		Voronoi::Generator generator(sites);
 		auto edges = generator.getEdges();
-		printEdges(edges, 'F');
+		printEdges(edges, sites, 'F');
+	}
+
+
+	TEST(ThreeSites_VertexAtCircumcenter)
+	{
+		std::vector<Voronoi::Point> sites;
+		sites.emplace_back(0.3, 0.7);
+		sites.emplace_back(0.7, 0.7);
+		sites.emplace_back(0.5, 0.3);
+
+		Voronoi::Generator generator(sites);
+		auto edges = generator.getEdges();
+		printEdges(edges, sites, 'V');
+
+		// The circumcenter is (0.5, 0.55)
+		int count = 0;
+		for (const auto & edge : edges) {
+			for (const auto & point : { edge.begin(), edge.end() }) {
+				if (!point.isNull() && std::abs(point.x() - 0.5) < 1e-9 && std::abs(point.y() - 0.55) < 1e-9) {
+					++count;
+				}
+			}
+		}
+		CHECK(count >= 3);
+	}
+
+
+	TEST(ThreeSites_CircleBelowMinY)
+	{
+		// The circle reaches below the box, its center (0.5, 0.095) is still inside
+		std::vector<Voronoi::Point> sites;
+		sites.emplace_back(0.3, 0.05);
+		sites.emplace_back(0.7, 0.05);
+		sites.emplace_back(0.5, 0.3);
+
+		Voronoi::Generator generator(sites);
+		auto edges = generator.getEdges();
+		printEdges(edges, sites, 'M');
+
+		CHECK_EQUAL(3u, edges.size());
+		int count = 0;
+		for (const auto & edge : edges) {
+			for (const auto & point : { edge.begin(), edge.end() }) {
+				if (!point.isNull() && std::abs(point.x() - 0.5) < 1e-9 && std::abs(point.y() - 0.095) < 1e-9) {
+					++count;
+				}
+			}
+		}
+		CHECK_EQUAL(3, count);
+	}
+
+
+	TEST(ThreeSites_MeshSharesVertex)
+	{
+		std::vector<Voronoi::Point> sites;
+		sites.emplace_back(0.3, 0.7);
+		sites.emplace_back(0.7, 0.7);
+		sites.emplace_back(0.5, 0.3);
+
+		Voronoi::Generator generator(sites);
+		auto mesh = generator.getMesh();
+		CHECK_EQUAL(2 * mesh.edgeCount(), mesh.sites.size());
+
+		// The circumcenter (0.5, 0.55) is stored once and shared by the edges
+		size_t vertex = mesh.vertexCount();
+		for (size_t i = 0; i < mesh.vertexCount(); ++i) {
+			if (std::abs(mesh.vertex(i).x() - 0.5) < 1e-9 && std::abs(mesh.vertex(i).y() - 0.55) < 1e-9) {
+				CHECK_EQUAL(mesh.vertexCount(), vertex);
+				vertex = i;
+			}
+		}
+		CHECK(vertex < mesh.vertexCount());
+		CHECK(std::count(mesh.edges.begin(), mesh.edges.end(), vertex) >= 3);
+		for (auto index : mesh.edges) {
+			CHECK(index < mesh.vertexCount());
+		}
+	}
+
+
+	TEST(Row_VerticalEdges)
+	{
+		std::vector<Voronoi::Point> sites;
+		for (int i = 0; i < 6; ++i) {
+			sites.emplace_back(0.1 + 0.15 * i, 0.5);
+		}
+
+		Voronoi::Generator generator(sites);
+		auto edges = generator.getEdges();
+		CHECK_EQUAL(5u, edges.size());
+		for (const auto & edge : edges) {
+			CHECK_EQUAL(1u, std::max(edge.leftSite(), edge.rightSite()) - std::min(edge.leftSite(), edge.rightSite()));
+			CHECK_CLOSE(edge.begin().x(), edge.end().x(), 1e-12);
+			CHECK_CLOSE(1.0, std::abs(edge.begin().y() - edge.end().y()), 1e-12);
+		}
+	}
+
+
+	TEST(Grid_EdgesBetweenNeighbours)
+	{
+		// Rows of sites with the same "y" and four sites on every circle
+		const int columns = 5;
+		const int rows = 4;
+		std::vector<Voronoi::Point> sites;
+		for (int row = 0; row < rows; ++row) {
+			for (int column = 0; column < columns; ++column) {
+				sites.emplace_back((column + 0.5) / columns, (row + 0.5) / rows);
+			}
+		}
+
+		Voronoi::Generator generator(sites);
+		auto edges = generator.getEdges();
+		CHECK_EQUAL(static_cast<size_t>((columns - 1) * rows + columns * (rows - 1)), edges.size());
+		for (const auto & edge : edges) {
+			const int dx = std::abs(static_cast<int>(edge.leftSite() % columns) - static_cast<int>(edge.rightSite() % columns));
+			const int dy = std::abs(static_cast<int>(edge.leftSite() / columns) - static_cast<int>(edge.rightSite() / columns));
+			CHECK_EQUAL(1, dx + dy);
+			const Voronoi::Point difference = edge.begin() - edge.end();
+			const double length = (dx == 1) ? 1.0 / rows : 1.0 / columns;
+			CHECK_CLOSE(length, std::sqrt(difference.x() * difference.x() + difference.y() * difference.y()), 1e-9);
+		}
+	}
+
+
+	TEST(SiteIndices_MatchInput)
+	{
+		std::vector<Voronoi::Point> sites;
+		sites.emplace_back(0.2, 0.7);
+		sites.emplace_back(1.5, 0.5);  // outside of the bounding box
+		sites.emplace_back(0.4, 0.1);
+		sites.emplace_back(0.7, 0.7);
+
+		Voronoi::Generator generator(sites);
+		auto edges = generator.getEdges();
+		CHECK_EQUAL(sites.size(), generator.getSites().size());
+		CHECK(std::equal(sites.begin(), sites.end(), generator.getSites().begin()));
+		CHECK(!edges.empty());
+		for (const auto & edge : edges) {
+			CHECK(edge.leftSite() != 1 && edge.rightSite() != 1);
+			CHECK(edge.leftSite() < sites.size() && edge.rightSite() < sites.size());
+			CHECK(edge.leftSite() != edge.rightSite());
+		}
+	}
+
+
+	TEST(Move_GenerateAfterwards)
+	{
+		const auto sites = randomSites(500, 7);
+		const Voronoi::Generator expected(sites);
+
+		// Moved in the middle of the sweep, the beachline must refer to the moved sites
+		Voronoi::Generator first;
+		first.start(sites);
+		first.step(100);
+		Voronoi::Generator second(std::move(first));
+		while (!second.step(100)) {
+		}
+		CHECK(sameEdges(expected.getEdges(), second.getEdges()));
+
+		second.generate(randomSites(500, 8));
+		Voronoi::Generator third(std::move(second));
+		third.generate(sites);
+		CHECK(sameEdges(expected.getEdges(), third.getEdges()));
+
+		// The moved-from generator is empty and can be used again
+		first.generate(sites);
+		CHECK(sameEdges(expected.getEdges(), first.getEdges()));
+	}
+
+
+	TEST(BoundingBox_Wrap)
+	{
+		Voronoi::BoundingBox box(0, 2, 0, 1);
+		auto wrapped = box.wrap(Voronoi::Point(-0.5, 1.25));
+		CHECK_CLOSE(1.5, wrapped.x(), 1e-12);
+		CHECK_CLOSE(0.25, wrapped.y(), 1e-12);
+	}
+
+
+	TEST(Periodic_EdgesInsideBox)
+	{
+		std::vector<Voronoi::Point> sites;
+		sites.emplace_back(0.2, 0.7);
+		sites.emplace_back(0.9, 0.2);
+		sites.emplace_back(0.6, 0.1);
+		sites.emplace_back(0.5, 0.5);
+
+		Voronoi::BoundingBox box;
+		box.Periodic = true;
+		box.Margin = 0.5;
+		Voronoi::Generator generator(sites, box);
+		auto edges = generator.getEdges();
+		printEdges(edges, sites, 'P');
+
+		// Ghost sites are mapped back to the original ones
+		CHECK(!edges.empty());
+		CHECK_EQUAL(sites.size(), generator.getSites().size());
+		for (const auto & edge : edges) {
+			for (const auto & point : { edge.begin(), edge.end() }) {
+				CHECK(point.x() >= box.MinX && point.x() <= box.MaxX);
+				CHECK(point.y() >= box.MinY && point.y() <= box.MaxY);
+			}
+			CHECK(edge.leftSite() < sites.size());
+			CHECK(edge.rightSite() < sites.size());
+		}
+	}
+
+
+	TEST(Periodic_SameAsReplicated)
+	{
+		// The automatic margin must be wide enough for the diagram of all 3x3 copies of the sites
+		const auto sites = randomSites(300, 9);
+		Voronoi::BoundingBox box;
+		box.Periodic = true;
+		const Voronoi::Generator generator(sites, box);
+
+		std::vector<Voronoi::Point> replicated;
+		for (int dy = -1; dy <= 1; ++dy) {
+			for (int dx = -1; dx <= 1; ++dx) {
+				for (const auto & site : sites) {
+					replicated.emplace_back(site.x() + dx, site.y() + dy);
+				}
+			}
+		}
+		const Voronoi::BoundingBox all(-1.0, 2.0, -1.0, 2.0);
+		const Voronoi::Generator reference(replicated, all);
+		Voronoi::EdgeList expected;
+		for (const auto & edge : clipEdges(reference.getEdges(), Voronoi::BoundingBox())) {
+			expected.emplace_back(edge.leftSite() % sites.size(), edge.rightSite() % sites.size());
+			expected.back().setBegin(edge.begin());
+			expected.back().setEnd(edge.end());
+		}
+		CHECK_EQUAL(expected.size(), generator.getEdges().size());
+		CHECK(sameEdges(expected, generator.getEdges()));
+	}
+
+
+	TEST(Step_SameAsGenerate)
+	{
+		std::vector<Voronoi::Point> sites;
+		for (int i = 0; i < 500; ++i) {
+			sites.emplace_back(((i * 37) % 499 + 0.5) / 500.0, ((i * 91) % 497 + 0.5) / 500.0);
+		}
+		Voronoi::BoundingBox periodic;
+		periodic.Periodic = true;
+		for (const auto & box : { Voronoi::BoundingBox(), periodic }) {
+			const Voronoi::Generator expected(sites, box);
+			Voronoi::Generator generator;
+			generator.start(sites, box);
+			size_t stepCount = 0;
+			while (!generator.step(50)) {
+				CHECK(!generator.isFinished());
+				++stepCount;
+			}
+			CHECK(generator.isFinished());
+			CHECK(stepCount > 10);
+			CHECK_EQUAL(expected.getEdges().size(), generator.getEdges().size());
+			CHECK_EQUAL(sites.size(), generator.getSites().size());
+			auto expectedEdge = expected.getEdges().begin();
+			for (const auto & edge : generator.getEdges()) {
+				CHECK(edge.begin() == expectedEdge->begin() && edge.end() == expectedEdge->end());
+				++expectedEdge;
+			}
+		}
+	}
+
+
+	TEST(Step_TimeBudget)
+	{
+		std::vector<Voronoi::Point> sites;
+		for (int i = 0; i < 2000; ++i) {
+			sites.emplace_back(((i * 37) % 1999 + 0.5) / 2000.0, ((i * 91) % 1997 + 0.5) / 2000.0);
+		}
+		Voronoi::Generator generator;
+		generator.start(sites);
+		while (!generator.step(std::chrono::microseconds(100))) {
+		}
+		CHECK_EQUAL(Voronoi::Generator(sites).getEdges().size(), generator.getEdges().size());
+
+		// Finished diagram stays as it is
+		CHECK(generator.step(1));
+	}
+
+
+	TEST(Update_SameAsGenerate)
+	{
+		std::vector<Voronoi::Point> sites;
+		for (int i = 0; i < 500; ++i) {
+			sites.emplace_back(((i * 37) % 499 + 0.5) / 500.0, ((i * 91) % 497 + 0.5) / 500.0);
+		}
+		Voronoi::BoundingBox periodic;
+		periodic.Periodic = true;
+		for (const auto & box : { Voronoi::BoundingBox(), periodic }) {
+			Voronoi::Generator generator(sites, box);
+			auto moved = sites;
+			for (int frame = 0; frame < 3; ++frame) {
+				// Sites swap their vertical order with the close neighbours
+				for (size_t i = 0; i < moved.size(); ++i) {
+					const double shift = 0.002 * std::sin(static_cast<double>(i + frame));
+					moved[i] = Voronoi::Point(moved[i].x(), std::min(std::max(moved[i].y() + shift, 0.001), 0.999));
+				}
+				generator.update(moved);
+				const Voronoi::Generator expected(moved, box);
+				CHECK_EQUAL(expected.getEdges().size(), generator.getEdges().size());
+				auto expectedEdge = expected.getEdges().begin();
+				for (const auto & edge : generator.getEdges()) {
+					CHECK(edge.begin() == expectedEdge->begin() && edge.end() == expectedEdge->end());
+					++expectedEdge;
+				}
+			}
+		}
+	}
+
+
+	TEST(Update_SitesLeaveAndEnterBox)
+	{
+		const Voronoi::BoundingBox box(0.0, 1.0, 0.0, 1.0);
+		std::vector<Voronoi::Point> sites;
+		sites.emplace_back(0.2, 0.7);
+		sites.emplace_back(0.9, 0.2);
+		sites.emplace_back(0.6, 0.1);
+		sites.emplace_back(0.5, 1.5);
+		Voronoi::Generator generator(sites, box);
+		CHECK_EQUAL(3u, generator.getEdges().size());
+
+		sites[3] = Voronoi::Point(0.5, 0.5);
+		generator.update(sites);
+		CHECK_EQUAL(Voronoi::Generator(sites, box).getEdges().size(), generator.getEdges().size());
+
+		sites[0] = Voronoi::Point(-0.2, 0.7);
+		generator.update(sites);
+		CHECK_EQUAL(Voronoi::Generator(sites, box).getEdges().size(), generator.getEdges().size());
+	}
+
+
+	TEST(Unclipped_SameAsGenerate)
+	{
+		const auto sites = randomSites(500, 1);
+		Voronoi::Generator generator;
+		generator.generateUnclipped(sites);
+		const Voronoi::Generator expected(sites);
+		CHECK(sameEdges(clipEdges(expected.getEdges(), Voronoi::BoundingBox()), generator.getEdges()));
+
+		// Rays and lines have a null end, all edges stay between the same sites
+		size_t rayCount = 0;
+		for (const auto & edge : generator.getUnclippedEdges()) {
+			rayCount += (edge.begin().isNull() || edge.end().isNull()) ? 1 : 0;
+		}
+		CHECK(rayCount > 0);
+		CHECK(generator.getUnclippedEdges().size() >= generator.getEdges().size());
+	}
+
+
+	TEST(Clip_SubBoxSameAsClippedDiagram)
+	{
+		const auto sites = randomSites(2000, 2);
+		Voronoi::Generator generator;
+		generator.generateUnclipped(sites);
+		const Voronoi::EdgeList whole = generator.getEdges();
+		for (const auto & box : { Voronoi::BoundingBox(0.2, 0.3, 0.6, 0.9), Voronoi::BoundingBox(0.0, 0.5, 0.5, 1.0),
+			Voronoi::BoundingBox(0.45, 0.55, 0.45, 0.55) }) {
+			generator.clip(box);
+			CHECK(sameEdges(clipEdges(whole, box), generator.getEdges()));
+		}
+	}
+
+
+	TEST(Clip_SitesOutsideOfBox)
+	{
+		const auto sites = randomSites(300, 3);
+		std::vector<Voronoi::Point> scaled;
+		for (const auto & site : sites) {
+			scaled.push_back(site * 3.0 - Voronoi::Point(1.0, 1.0));
+		}
+		Voronoi::Generator generator;
+		generator.generateUnclipped(scaled);
+		bool hasOutsideSite = false;
+		for (const auto & edge : generator.getEdges()) {
+			CHECK(edge.begin().x() >= 0.0 && edge.begin().x() <= 1.0 && edge.begin().y() >= 0.0 && edge.begin().y() <= 1.0);
+			CHECK(edge.end().x() >= 0.0 && edge.end().x() <= 1.0 && edge.end().y() >= 0.0 && edge.end().y() <= 1.0);
+			const Voronoi::BoundingBox box;
+			hasOutsideSite = hasOutsideSite || !box.contains(scaled[edge.leftSite()]) || !box.contains(scaled[edge.rightSite()]);
+		}
+		CHECK(hasOutsideSite);
+
+		// Zoom out to all sites
+		const Voronoi::BoundingBox all(-1.0, 2.0, -1.0, 2.0);
+		generator.clip(all);
+		CHECK(sameEdges(clipEdges(Voronoi::Generator(scaled, all).getEdges(), all), generator.getEdges()));
+	}
+
+
+	TEST(Clip_ClippedDiagramThrows)
+	{
+		Voronoi::Generator generator(randomSites(10, 4));
+		CHECK_THROW(generator.clip(Voronoi::BoundingBox(0.0, 0.5, 0.0, 0.5)), std::logic_error);
+	}
+
+
+	TEST(ClipTiles_SameAsClippedDiagram)
+	{
+		const auto sites = randomSites(3000, 5);
+		Voronoi::MonotonicBuffer buffer;
+		Voronoi::Generator generator(&buffer);
+		generator.generateUnclipped(sites);
+		const Voronoi::BoundingBox box(0.1, 0.9, 0.2, 1.0);
+
+		// Each tile cut out of the diagram of the whole box by `clipEdge`
+		const Voronoi::Generator whole(sites);
+		std::vector<Voronoi::EdgeList> expected;
+		for (size_t row = 0; row < 3; ++row) {
+			for (size_t column = 0; column < 5; ++column) {
+				const Voronoi::BoundingBox tile(0.1 + 0.8 * column / 5.0, column == 4 ? 0.9 : 0.1 + 0.8 * (column + 1) / 5.0,
+					0.2 + 0.8 * row / 3.0, row == 2 ? 1.0 : 0.2 + 0.8 * (row + 1) / 3.0);
+				expected.push_back(clipEdges(whole.getEdges(), tile));
+			}
+		}
+
+		Voronoi::ThreadPool pool(4);
+		for (Voronoi::ThreadPool * tilePool : { static_cast<Voronoi::ThreadPool *>(nullptr), &pool }) {
+			const auto tiles = generator.clipTiles(box, 5, 3, tilePool);
+			CHECK_EQUAL(15u, tiles.size());
+			CHECK(tiles.get_allocator().resource() == &buffer);
+			for (size_t tile = 0; tile < tiles.size(); ++tile) {
+				CHECK(tiles[tile].get_allocator().resource() == &buffer);
+				CHECK(sameEdges(expected[tile], Voronoi::EdgeList(tiles[tile].begin(), tiles[tile].end())));
+			}
+		}
+		CHECK_THROW(Voronoi::Generator(randomSites(10, 6)).clipTiles(box, 2, 2), std::logic_error);
 	}
 }
 
@@ -0,0 +1,28 @@
+#include "tiling.h"
+#include <exception>
+#include <iostream>
+
+
+/// @mainpage
+///
+/// Worker process of `Voronoi::TiledGenerator`: "VoronoiTileWorker <input> <output>".
+///
+/// Set `TilingOptions::WorkerCommand` to the path of this executable. On a cluster the
+/// command may wrap it in a remote launcher as long as the tile directory is shared.
+
+
+int main(int argc, char * argv[])
+{
+	if (argc != 3) {
+		std::cerr << "Usage: " << argv[0] << " <input> <output>" << std::endl;
+		return 2;
+	}
+	try {
+		Voronoi::runTileWorker(argv[1], argv[2]);
+	}
+	catch (const std::exception & e) {
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
+	return 0;
+}